@@ -0,0 +1,323 @@
+// Cost of each generator's synthesis kernels and filter cascades, one at a time.
+// Every kernel runs from fixed state (rate, seed, parameters and input audio)
+// for one 512-sample block per iteration, so a change to a single kernel can be
+// measured without the rest of processBlock around it.
+
+#include <benchmark/benchmark.h>
+#include <JuceHeader.h>
+#include "../Source/AudioEngine/HydraulicHiss.h"
+#include "../Source/AudioEngine/ServoWhine.h"
+#include "../Source/AudioEngine/GearGrind.h"
+#include "../Source/AudioEngine/MetalImpact.h"
+#include "../Source/AudioEngine/SamplePlayback.h"
+
+// Reaches the private kernels; each generator declares it a friend
+struct GeneratorKernelAccess
+{
+    using Context = juce::dsp::ProcessContextReplacing<float>;
+
+    // Hydraulic hiss
+    static void setHydraulicState(HydraulicHiss& g, float pressure, float flow)
+    {
+        g.currentPressure = pressure;
+        g.currentFlow = flow;
+    }
+
+    static float generateHydraulicHiss(HydraulicHiss& g) { return g.generateHydraulicHiss(); }
+    static float generatePressureCycle(HydraulicHiss& g) { return g.generatePressureCycle(); }
+    static float generateFlowNoise(HydraulicHiss& g) { return g.generateFlowNoise(); }
+
+    static void processFilters(HydraulicHiss& g, const Context& context)
+    {
+        g.highPassFilter.process(context);
+        g.lowPassFilter.process(context);
+        g.bandPassFilter.process(context);
+    }
+
+    // Servo whine
+    static void setServoSpeed(ServoWhine& g, float speed) { g.speedRamp.setCurrentAndTargetValue(speed); }
+
+    static float generateServoWhine(ServoWhine& g) { return g.generateServoWhine(); }
+    static float generateMotorNoise(ServoWhine& g) { return g.generateMotorNoise(); }
+
+    static void processFilters(ServoWhine& g, const Context& context)
+    {
+        g.highPassFilter.process(context);
+        g.resonantFilter.process(context);
+    }
+
+    // Gear grind
+    static void setGearSpeed(GearGrind& g, float speed) { g.currentSpeed = speed; }
+
+    // Returns one tooth's engagement so the update can't be optimised away
+    static float updateGearTeeth(GearGrind& g)
+    {
+        g.updateGearTeeth();
+        return g.gearTeeth[0].engagement;
+    }
+
+    static void processFilters(GearGrind& g, const Context& context)
+    {
+        g.highPassFilter.process(context);
+        g.bandPassFilter1.process(context);
+        g.bandPassFilter2.process(context);
+        g.notchFilter.process(context);
+    }
+
+    // Metal impact
+    static void setMetalState(MetalImpact& g, float resonance, float decay)
+    {
+        g.currentResonance = resonance;
+        g.currentDecay = decay;
+        g.updateFilterFrequencies();
+    }
+
+    static void triggerImpact(MetalImpact& g, float velocity, int note) { g.triggerImpact(velocity, note); }
+    static float generateMetallicResonance(MetalImpact& g) { return g.generateMetallicResonance(); }
+
+    static void processFilters(MetalImpact& g, const Context& context)
+    {
+        g.highPassFilter.process(context);
+        g.resonantFilter1.process(context);
+        g.resonantFilter2.process(context);
+    }
+
+    // Sample playback
+    static float interpolateSample(SamplePlayback& g, const SampleData& sample, int channel, float position)
+    {
+        return g.interpolateSample(sample, channel, position);
+    }
+};
+
+namespace
+{
+    using Access = GeneratorKernelAccess;
+
+    constexpr double benchSampleRate = 48000.0;
+    constexpr int benchBlockSize = 512;
+    constexpr juce::int64 benchSeed = 0x5eed;
+
+    template <typename Generator>
+    void prepareGenerator(Generator& generator)
+    {
+        generator.prepare(benchSampleRate, benchBlockSize);
+        generator.reset();
+    }
+
+    // Calls kernel once per sample of a block and keeps the results alive
+    template <typename Kernel>
+    void runPerSample(benchmark::State& state, Kernel&& kernel)
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        for (auto _ : state)
+        {
+            float sum = 0.0f;
+
+            for (int i = 0; i < benchBlockSize; ++i)
+                sum += kernel();
+
+            benchmark::DoNotOptimize(sum);
+        }
+
+        state.SetItemsProcessed(state.iterations() * benchBlockSize);
+    }
+
+    // Runs a generator's filter cascade over the same block of noise each
+    // iteration. The generators' filters are single-channel and only ever touch
+    // the first channel, so a mono block costs the same as the stereo one.
+    template <typename Generator>
+    void runFilterCascade(benchmark::State& state, Generator& generator)
+    {
+        juce::ScopedNoDenormals noDenormals;
+
+        juce::AudioBuffer<float> input(1, benchBlockSize);
+        juce::Random random(benchSeed);
+
+        for (int i = 0; i < benchBlockSize; ++i)
+            input.setSample(0, i, random.nextFloat() * 2.0f - 1.0f);
+
+        juce::AudioBuffer<float> work(1, benchBlockSize);
+        juce::dsp::AudioBlock<float> block(work);
+        Access::Context context(block);
+
+        for (auto _ : state)
+        {
+            work.copyFrom(0, 0, input, 0, 0, benchBlockSize);
+            Access::processFilters(generator, context);
+            benchmark::DoNotOptimize(work.getReadPointer(0));
+            benchmark::ClobberMemory();
+        }
+
+        state.SetItemsProcessed(state.iterations() * benchBlockSize);
+    }
+
+    void prepareHydraulic(HydraulicHiss& hiss)
+    {
+        hiss.setSeed(benchSeed);
+        prepareGenerator(hiss);
+        Access::setHydraulicState(hiss, 5.0f, 2.5f);
+    }
+
+    void prepareServo(ServoWhine& servo)
+    {
+        prepareGenerator(servo);
+        Access::setServoSpeed(servo, 50.0f);
+    }
+
+    void prepareGear(GearGrind& gear)
+    {
+        gear.setSeed(benchSeed);
+        prepareGenerator(gear);
+        Access::setGearSpeed(gear, 2.0f);
+    }
+
+    void prepareMetal(MetalImpact& metal)
+    {
+        metal.setSeed(benchSeed);
+        prepareGenerator(metal);
+        Access::setMetalState(metal, 0.5f, 1.0f);
+    }
+}
+
+//==============================================================================
+static void BM_HydraulicHiss_GenerateHydraulicHiss(benchmark::State& state)
+{
+    HydraulicHiss hiss;
+    prepareHydraulic(hiss);
+    runPerSample(state, [&hiss] { return Access::generateHydraulicHiss(hiss); });
+}
+BENCHMARK(BM_HydraulicHiss_GenerateHydraulicHiss);
+
+static void BM_HydraulicHiss_GeneratePressureCycle(benchmark::State& state)
+{
+    HydraulicHiss hiss;
+    prepareHydraulic(hiss);
+    runPerSample(state, [&hiss] { return Access::generatePressureCycle(hiss); });
+}
+BENCHMARK(BM_HydraulicHiss_GeneratePressureCycle);
+
+static void BM_HydraulicHiss_GenerateFlowNoise(benchmark::State& state)
+{
+    HydraulicHiss hiss;
+    prepareHydraulic(hiss);
+    runPerSample(state, [&hiss] { return Access::generateFlowNoise(hiss); });
+}
+BENCHMARK(BM_HydraulicHiss_GenerateFlowNoise);
+
+static void BM_HydraulicHiss_FilterCascade(benchmark::State& state)
+{
+    HydraulicHiss hiss;
+    prepareHydraulic(hiss);
+    runFilterCascade(state, hiss);
+}
+BENCHMARK(BM_HydraulicHiss_FilterCascade);
+
+//==============================================================================
+static void BM_ServoWhine_GenerateServoWhine(benchmark::State& state)
+{
+    ServoWhine servo;
+    prepareServo(servo);
+    runPerSample(state, [&servo] { return Access::generateServoWhine(servo); });
+}
+BENCHMARK(BM_ServoWhine_GenerateServoWhine);
+
+static void BM_ServoWhine_GenerateMotorNoise(benchmark::State& state)
+{
+    ServoWhine servo;
+    prepareServo(servo);
+    runPerSample(state, [&servo] { return Access::generateMotorNoise(servo); });
+}
+BENCHMARK(BM_ServoWhine_GenerateMotorNoise);
+
+static void BM_ServoWhine_FilterCascade(benchmark::State& state)
+{
+    ServoWhine servo;
+    prepareServo(servo);
+    runFilterCascade(state, servo);
+}
+BENCHMARK(BM_ServoWhine_FilterCascade);
+
+//==============================================================================
+static void BM_GearGrind_UpdateGearTeeth(benchmark::State& state)
+{
+    GearGrind gear;
+    prepareGear(gear);
+    runPerSample(state, [&gear] { return Access::updateGearTeeth(gear); });
+}
+BENCHMARK(BM_GearGrind_UpdateGearTeeth);
+
+static void BM_GearGrind_FilterCascade(benchmark::State& state)
+{
+    GearGrind gear;
+    prepareGear(gear);
+    runFilterCascade(state, gear);
+}
+BENCHMARK(BM_GearGrind_FilterCascade);
+
+//==============================================================================
+// All eight partials ring; the impact is retriggered at the start of every
+// block so they never decay out and the workload stays the same
+static void BM_MetalImpact_GenerateMetallicResonance(benchmark::State& state)
+{
+    MetalImpact metal;
+    prepareMetal(metal);
+    juce::ScopedNoDenormals noDenormals;
+
+    for (auto _ : state)
+    {
+        Access::triggerImpact(metal, 1.0f, 64);
+        float sum = 0.0f;
+
+        for (int i = 0; i < benchBlockSize; ++i)
+            sum += Access::generateMetallicResonance(metal);
+
+        benchmark::DoNotOptimize(sum);
+    }
+
+    state.SetItemsProcessed(state.iterations() * benchBlockSize);
+}
+BENCHMARK(BM_MetalImpact_GenerateMetallicResonance);
+
+static void BM_MetalImpact_FilterCascade(benchmark::State& state)
+{
+    MetalImpact metal;
+    prepareMetal(metal);
+    runFilterCascade(state, metal);
+}
+BENCHMARK(BM_MetalImpact_FilterCascade);
+
+//==============================================================================
+// Reads a 1 second float32 sample at a fixed non-integer pitch, wrapping round
+static void BM_SamplePlayback_InterpolateSample(benchmark::State& state)
+{
+    constexpr float pitch = 1.37f;
+
+    juce::AudioBuffer<float> audio(2, static_cast<int>(benchSampleRate));
+    juce::Random random(benchSeed);
+
+    for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+        for (int i = 0; i < audio.getNumSamples(); ++i)
+            audio.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+    SampleData::Ptr sample = new SampleData(std::move(audio), benchSampleRate);
+    SamplePlayback player;
+    prepareGenerator(player);
+
+    const auto endPosition = static_cast<float>(sample->getNumFrames() - 1);
+    float position = 0.0f;
+
+    runPerSample(state, [&]
+    {
+        auto value = Access::interpolateSample(player, *sample, 0, position);
+
+        position += pitch;
+        if (position >= endPosition)
+            position -= endPosition;
+
+        return value;
+    });
+}
+BENCHMARK(BM_SamplePlayback_InterpolateSample);
+
+BENCHMARK_MAIN();
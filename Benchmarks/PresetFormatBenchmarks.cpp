@@ -0,0 +1,172 @@
+// Save and load throughput of the binary preset format against the legacy
+// JSON + embedded XML format, over a bank of 10k presets.
+// The *_Encode/_Decode runs measure serialisation alone; the *_Bank runs include
+// writing and reading one file per preset in a temporary directory.
+
+#include <benchmark/benchmark.h>
+#include <JuceHeader.h>
+#include "../Source/Preset/PresetSerialization.h"
+
+namespace
+{
+    constexpr int bankSize = 10000;
+
+    std::vector<PresetSerialization::Preset> makeBank()
+    {
+        std::vector<PresetSerialization::Preset> bank;
+        bank.reserve(bankSize);
+        juce::Random random(0x5eed);
+
+        for (int i = 0; i < bankSize; ++i)
+        {
+            juce::ValueTree state(PresetSchema::stateType);
+
+            for (const auto& parameter : PresetSchema::parameters)
+                state.appendChild(juce::ValueTree("PARAM", { { "id", parameter.parameterId },
+                                                             { "value", random.nextFloat() } }), nullptr);
+
+            bank.push_back({ "Preset " + juce::String(i), { "bench", "tag" + juce::String(i % 16) }, state });
+        }
+
+        return bank;
+    }
+
+    const std::vector<PresetSerialization::Preset>& getBank()
+    {
+        static const auto bank = makeBank();
+        return bank;
+    }
+
+    void reportBank(benchmark::State& state, int64_t bytesPerBank)
+    {
+        state.SetItemsProcessed(state.iterations() * bankSize);
+        state.counters["bankMB"] = static_cast<double>(bytesPerBank) / (1024.0 * 1024.0);
+    }
+}
+
+static void BM_Preset_Legacy_Encode(benchmark::State& state)
+{
+    const auto& bank = getBank();
+    int64_t bytes = 0;
+
+    for (auto _ : state)
+    {
+        bytes = 0;
+        for (const auto& preset : bank)
+            bytes += static_cast<int64_t>(PresetSerialization::toLegacyJson(preset).getNumBytesAsUTF8());
+    }
+
+    reportBank(state, bytes);
+}
+BENCHMARK(BM_Preset_Legacy_Encode)->Unit(benchmark::kMillisecond);
+
+static void BM_Preset_Binary_Encode(benchmark::State& state)
+{
+    const auto& bank = getBank();
+    int64_t bytes = 0;
+
+    for (auto _ : state)
+    {
+        bytes = 0;
+        for (const auto& preset : bank)
+            bytes += static_cast<int64_t>(PresetSerialization::toBinary(preset).getSize());
+    }
+
+    reportBank(state, bytes);
+}
+BENCHMARK(BM_Preset_Binary_Encode)->Unit(benchmark::kMillisecond);
+
+static void BM_Preset_Legacy_Decode(benchmark::State& state)
+{
+    juce::StringArray encoded;
+    for (const auto& preset : getBank())
+        encoded.add(PresetSerialization::toLegacyJson(preset));
+
+    for (auto _ : state)
+    {
+        PresetSerialization::Preset preset;
+        for (const auto& json : encoded)
+        {
+            PresetSerialization::fromLegacyJson(json, preset);
+            benchmark::DoNotOptimize(preset.state);
+        }
+    }
+
+    reportBank(state, static_cast<int64_t>(encoded.joinIntoString({}).getNumBytesAsUTF8()));
+}
+BENCHMARK(BM_Preset_Legacy_Decode)->Unit(benchmark::kMillisecond);
+
+static void BM_Preset_Binary_Decode(benchmark::State& state)
+{
+    std::vector<juce::MemoryBlock> encoded;
+    int64_t bytes = 0;
+
+    for (const auto& preset : getBank())
+    {
+        encoded.push_back(PresetSerialization::toBinary(preset));
+        bytes += static_cast<int64_t>(encoded.back().getSize());
+    }
+
+    for (auto _ : state)
+    {
+        PresetSerialization::Preset preset;
+        for (const auto& data : encoded)
+        {
+            PresetSerialization::fromBinary(data.getData(), data.getSize(), preset);
+            benchmark::DoNotOptimize(preset.state);
+        }
+    }
+
+    reportBank(state, bytes);
+}
+BENCHMARK(BM_Preset_Binary_Decode)->Unit(benchmark::kMillisecond);
+
+// Writes the bank to disk and reads it back, the way the preset index sees it
+static void saveAndLoadBank(benchmark::State& state, const char* extension, bool binary)
+{
+    const auto& bank = getBank();
+    juce::TemporaryFile tempDir;
+    auto directory = tempDir.getFile();
+    directory.createDirectory();
+
+    for (auto _ : state)
+    {
+        for (const auto& preset : bank)
+        {
+            auto file = directory.getChildFile(preset.name + extension);
+
+            if (binary)
+                PresetSerialization::writeFile(file, preset);
+            else
+                file.replaceWithText(PresetSerialization::toLegacyJson(preset));
+        }
+
+        PresetSerialization::Preset loaded;
+        for (const auto& preset : bank)
+        {
+            PresetSerialization::readFile(directory.getChildFile(preset.name + extension), loaded);
+            benchmark::DoNotOptimize(loaded.state);
+        }
+    }
+
+    int64_t bytes = 0;
+    for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*", juce::File::findFiles))
+        bytes += entry.getFileSize();
+
+    reportBank(state, bytes);
+    directory.deleteRecursively();
+}
+
+static void BM_Preset_Legacy_Bank(benchmark::State& state)
+{
+    saveAndLoadBank(state, PresetSerialization::legacyExtension, false);
+}
+BENCHMARK(BM_Preset_Legacy_Bank)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+static void BM_Preset_Binary_Bank(benchmark::State& state)
+{
+    saveAndLoadBank(state, PresetSerialization::binaryExtension, true);
+}
+BENCHMARK(BM_Preset_Binary_Bank)->Unit(benchmark::kMillisecond)->Iterations(3);
+
+BENCHMARK_MAIN();
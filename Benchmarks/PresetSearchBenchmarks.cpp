@@ -0,0 +1,101 @@
+// Query latency of PresetSearchIndex over a 10k-preset library.
+// A UI frame is ~16 ms; every query here should stay well below that.
+
+#include <benchmark/benchmark.h>
+#include <JuceHeader.h>
+#include "../Source/Preset/PresetSearchIndex.h"
+
+namespace
+{
+    constexpr int librarySize = 10000;
+
+    const char* const nameWords[] = { "Heavy", "Light", "Scout", "Titan", "Servo", "Hydraulic", "Gear",
+                                      "Impact", "Damaged", "Stomp", "Walker", "Drone", "Rusty", "Prime",
+                                      "Assault", "Recon", "Colossus", "Piston", "Grinder", "Sentinel" };
+
+    const char* const tagWords[] = { "footsteps", "ambience", "impact", "loop", "one-shot", "metal",
+                                     "industrial", "cinematic", "ui", "weapon" };
+
+    const char* const categories[] = { "Movement", "Impacts", "Ambience", "Machinery", "Weapons" };
+
+    const PresetSearchIndex& getLibrary()
+    {
+        static const PresetSearchIndex library = []
+        {
+            PresetSearchIndex index;
+            juce::Random random(0x5eed);
+
+            auto pick = [&random](const auto& words)
+            {
+                return juce::String(words[random.nextInt(static_cast<int>(std::size(words)))]);
+            };
+
+            for (int i = 0; i < librarySize; ++i)
+            {
+                PresetSearchIndex::Document document;
+                document.name = pick(nameWords) + " " + pick(nameWords) + " " + juce::String(i);
+                document.key = document.name;
+                document.tags = { pick(tagWords), pick(tagWords) };
+                document.category = pick(categories);
+                document.author = "Author " + juce::String(i % 50);
+
+                for (auto& value : document.fingerprint)
+                    value = random.nextFloat();
+
+                index.add(document);
+            }
+
+            return index;
+        }();
+
+        return library;
+    }
+
+    void runQuery(benchmark::State& state, const char* query)
+    {
+        const auto& library = getLibrary();
+
+        for (auto _ : state)
+            benchmark::DoNotOptimize(library.search(query, 100));
+
+        state.counters["results"] = static_cast<double>(library.search(query, librarySize).size());
+    }
+}
+
+static void BM_PresetSearch_Prefix(benchmark::State& state) { runQuery(state, "tit"); }
+BENCHMARK(BM_PresetSearch_Prefix)->Unit(benchmark::kMicrosecond);
+
+static void BM_PresetSearch_TwoWords(benchmark::State& state) { runQuery(state, "heavy walk"); }
+BENCHMARK(BM_PresetSearch_TwoWords)->Unit(benchmark::kMicrosecond);
+
+static void BM_PresetSearch_Typo(benchmark::State& state) { runQuery(state, "colosus"); }
+BENCHMARK(BM_PresetSearch_Typo)->Unit(benchmark::kMicrosecond);
+
+static void BM_PresetSearch_Filtered(benchmark::State& state) { runQuery(state, "tag:metal category:impacts rusty"); }
+BENCHMARK(BM_PresetSearch_Filtered)->Unit(benchmark::kMicrosecond);
+
+// One query per keystroke, as a search box issues them
+static void BM_PresetSearch_Incremental(benchmark::State& state)
+{
+    const auto& library = getLibrary();
+    const juce::String typed = "sentinel grinder";
+
+    for (auto _ : state)
+        for (int length = 1; length <= typed.length(); ++length)
+            benchmark::DoNotOptimize(library.search(typed.substring(0, length), 100));
+
+    state.SetItemsProcessed(state.iterations() * typed.length());
+}
+BENCHMARK(BM_PresetSearch_Incremental)->Unit(benchmark::kMicrosecond);
+
+static void BM_PresetSearch_FindSimilar(benchmark::State& state)
+{
+    const auto& library = getLibrary();
+    auto target = library.search("prime", 1)[0];
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(library.findSimilar(target, 10));
+}
+BENCHMARK(BM_PresetSearch_FindSimilar)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,82 @@
+// Memory-vs-CPU tradeoff of SampleData storage formats.
+// Each run reports the resident size of a 30 second stereo sample alongside the
+// time taken to stream all of it through the block decoder.
+
+#include <benchmark/benchmark.h>
+#include <JuceHeader.h>
+#include "../Source/AudioEngine/SampleData.h"
+
+namespace
+{
+    constexpr double benchSampleRate = 48000.0;
+    constexpr int benchFrames = 30 * 48000;
+
+    SampleData::Ptr makeBenchSample(SampleData::StorageFormat format)
+    {
+        juce::AudioBuffer<float> audio(2, benchFrames);
+        juce::Random random(0x5eed);
+
+        for (int channel = 0; channel < audio.getNumChannels(); ++channel)
+            for (int i = 0; i < benchFrames; ++i)
+                audio.setSample(channel, i, random.nextFloat() * 2.0f - 1.0f);
+
+        return new SampleData(std::move(audio), benchSampleRate, format);
+    }
+
+    void streamAllBlocks(benchmark::State& state, SampleData::StorageFormat format)
+    {
+        auto sample = makeBenchSample(format);
+        std::array<float, SampleData::blockSize + 1> block{};
+
+        for (auto _ : state)
+        {
+            for (int channel = 0; channel < sample->getNumChannels(); ++channel)
+            {
+                for (int b = 0; b < sample->getNumBlocks(); ++b)
+                {
+                    sample->decodeBlock(channel, b, block.data());
+                    benchmark::DoNotOptimize(block.data());
+                }
+            }
+
+            benchmark::ClobberMemory();
+        }
+
+        auto framesPerIteration = static_cast<int64_t>(sample->getNumFrames()) * sample->getNumChannels();
+        state.SetItemsProcessed(state.iterations() * framesPerIteration);
+        state.counters["storedMB"] = static_cast<double>(sample->getMemoryFootprintBytes()) / (1024.0 * 1024.0);
+        state.counters["bytesPerFrame"] = static_cast<double>(sample->getMemoryFootprintBytes())
+            / static_cast<double>(framesPerIteration);
+    }
+}
+
+static void BM_SampleStorage_Float32(benchmark::State& state)
+{
+    streamAllBlocks(state, SampleData::StorageFormat::float32);
+}
+BENCHMARK(BM_SampleStorage_Float32)->Unit(benchmark::kMillisecond);
+
+static void BM_SampleStorage_Int16(benchmark::State& state)
+{
+    streamAllBlocks(state, SampleData::StorageFormat::int16);
+}
+BENCHMARK(BM_SampleStorage_Int16)->Unit(benchmark::kMillisecond);
+
+static void BM_SampleStorage_Int16SingleBlock(benchmark::State& state)
+{
+    auto sample = makeBenchSample(SampleData::StorageFormat::int16);
+    std::array<float, SampleData::blockSize + 1> block{};
+    int blockIndex = 0;
+
+    for (auto _ : state)
+    {
+        sample->decodeBlock(0, blockIndex, block.data());
+        benchmark::DoNotOptimize(block.data());
+        blockIndex = (blockIndex + 1) % sample->getNumBlocks();
+    }
+
+    state.SetItemsProcessed(state.iterations() * (SampleData::blockSize + 1));
+}
+BENCHMARK(BM_SampleStorage_Int16SingleBlock);
+
+BENCHMARK_MAIN();
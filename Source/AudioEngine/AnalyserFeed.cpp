@@ -0,0 +1,62 @@
+#include "AnalyserFeed.h"
+
+AnalyserFeed::AnalyserFeed()
+{
+    ring.calloc(capacity);
+}
+
+void AnalyserFeed::prepare(double newSampleRate)
+{
+    sampleRate.store(newSampleRate, std::memory_order_relaxed);
+}
+
+void AnalyserFeed::push(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    if (!enabled.load(std::memory_order_relaxed) || buffer.getNumChannels() == 0)
+        return;
+
+    auto numChannels = buffer.getNumChannels();
+    auto channelScale = 1.0f / static_cast<float>(numChannels);
+
+    const auto scope = fifo.write(juce::jmin(numSamples, fifo.getFreeSpace()));
+
+    // Sum the channels into the one or two free regions of the ring
+    auto writeRegion = [&](int ringStart, int size, int sourceStart)
+    {
+        if (size <= 0)
+            return;
+
+        auto* destination = ring.get() + ringStart;
+        juce::FloatVectorOperations::copyWithMultiply(destination, buffer.getReadPointer(0, sourceStart), channelScale, size);
+
+        for (int channel = 1; channel < numChannels; ++channel)
+            juce::FloatVectorOperations::addWithMultiply(destination, buffer.getReadPointer(channel, sourceStart), channelScale, size);
+    };
+
+    writeRegion(scope.startIndex1, scope.blockSize1, 0);
+    writeRegion(scope.startIndex2, scope.blockSize2, scope.blockSize1);
+}
+
+void AnalyserFeed::setEnabled(bool shouldBeEnabled)
+{
+    if (shouldBeEnabled && !isEnabled())
+    {
+        // Throw away whatever was left over from the last time
+        fifo.read(fifo.getNumReady());
+    }
+
+    enabled.store(shouldBeEnabled, std::memory_order_relaxed);
+}
+
+int AnalyserFeed::pull(float* destination, int maxSamples)
+{
+    const auto scope = fifo.read(juce::jmin(maxSamples, fifo.getNumReady()));
+
+    if (scope.blockSize1 > 0)
+        juce::FloatVectorOperations::copy(destination, ring.get() + scope.startIndex1, scope.blockSize1);
+
+    if (scope.blockSize2 > 0)
+        juce::FloatVectorOperations::copy(destination + scope.blockSize1, ring.get() + scope.startIndex2, scope.blockSize2);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Hands post-mix audio from the audio thread to the editor's analyser.
+//
+// A single-producer, single-consumer ring buffer built on juce::AbstractFifo,
+// carrying a mono sum of the output. The audio thread never waits: when the
+// reader falls behind the newest samples are dropped. Nothing is written while
+// no reader is enabled, so with the editor closed the cost is one atomic load
+// per block.
+class AnalyserFeed
+{
+public:
+    AnalyserFeed();
+
+    // Audio thread
+    void prepare(double sampleRate);
+    void push(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    // Reader side, normally the message thread
+    void setEnabled(bool shouldBeEnabled);
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    double getSampleRate() const { return sampleRate.load(std::memory_order_relaxed); }
+
+    // Copies up to maxSamples of the oldest pending audio; returns how many
+    int pull(float* destination, int maxSamples);
+
+    static constexpr int capacity = 1 << 15;
+
+private:
+    juce::AbstractFifo fifo{ capacity };
+    juce::HeapBlock<float> ring;
+
+    std::atomic<bool> enabled{ false };
+    std::atomic<double> sampleRate{ 44100.0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyserFeed)
+};
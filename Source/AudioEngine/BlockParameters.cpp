@@ -0,0 +1,26 @@
+#include "BlockParameters.h"
+
+BlockParameters::BlockParameters(juce::AudioProcessorValueTreeState& vts)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        rawValues[static_cast<size_t>(i)] = vts.getRawParameterValue(PresetSchema::parameters[i].parameterId);
+
+    capture();
+}
+
+void BlockParameters::capture()
+{
+    for (size_t i = 0; i < rawValues.size(); ++i)
+        baseValues[i] = rawValues[i] != nullptr ? rawValues[i]->load(std::memory_order_relaxed) : 0.0f;
+
+    values = baseValues;
+}
+
+int BlockParameters::indexOf(const char* parameterId)
+{
+    auto index = PresetSchema::indexOf(parameterId);
+
+    // Every parameter a generator reads must be in the schema
+    jassert(index >= 0);
+    return index;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../Preset/PresetSchema.h"
+
+// The plain parameter values the generators render one block with.
+//
+// capture() copies the parameters (the APVTS raw values) once at the top of
+// processBlock. Scripted ramps and modulation are then layered onto this copy,
+// never onto the parameters themselves, so the host, the editor, presets and
+// the saved session always see the user's own settings.
+class BlockParameters
+{
+public:
+    explicit BlockParameters(juce::AudioProcessorValueTreeState& vts);
+
+    // Audio thread
+    void capture();
+
+    // By position in the schema
+    float get(int index) const { return values[static_cast<size_t>(index)]; }
+    void set(int index, float value) { values[static_cast<size_t>(index)] = value; }
+
+    // The parameter's own value this block, before anything was layered on
+    float getBase(int index) const { return baseValues[static_cast<size_t>(index)]; }
+
+    // Schema position of a parameter ID, for resolving once outside the audio
+    // thread and reading with get(int) from then on
+    static int indexOf(const char* parameterId);
+
+private:
+    std::array<std::atomic<float>*, PresetSchema::numParameters> rawValues{};
+    PresetSchema::Values baseValues{};
+    PresetSchema::Values values{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(BlockParameters)
+};
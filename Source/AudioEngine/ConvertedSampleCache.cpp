@@ -0,0 +1,89 @@
+#include "ConvertedSampleCache.h"
+
+SampleData::Ptr ConvertedSampleCache::load(const juce::String& contentHash, double sampleRate,
+    SampleData::StorageFormat format) const
+{
+    if (contentHash.isEmpty())
+        return nullptr;
+
+    auto cacheFile = getCacheFile(contentHash, sampleRate);
+    if (!cacheFile.existsAsFile())
+        return nullptr;
+
+    juce::FileInputStream input(cacheFile);
+    if (!input.openedOk())
+        return nullptr;
+
+    if (input.readInt() != fileMagic || input.readInt() != fileVersion)
+        return nullptr;
+
+    auto numChannels = input.readInt();
+    auto numFrames = input.readInt();
+    auto storedRate = input.readDouble();
+
+    if (numChannels <= 0 || numFrames <= 0 || storedRate != sampleRate)
+        return nullptr;
+
+    auto bytesPerChannel = static_cast<size_t>(numFrames) * sizeof(float);
+    if (input.getNumBytesRemaining() < static_cast<juce::int64>(bytesPerChannel * static_cast<size_t>(numChannels)))
+        return nullptr;
+
+    juce::AudioBuffer<float> audio(numChannels, numFrames);
+
+    for (int channel = 0; channel < numChannels; ++channel)
+        if (input.read(audio.getWritePointer(channel), static_cast<int>(bytesPerChannel)) != static_cast<int>(bytesPerChannel))
+            return nullptr;
+
+    return new SampleData(std::move(audio), sampleRate, format, contentHash);
+}
+
+void ConvertedSampleCache::store(const juce::String& contentHash, double sampleRate,
+    const juce::AudioBuffer<float>& convertedAudio) const
+{
+    if (contentHash.isEmpty())
+        return;
+
+    auto cacheFile = getCacheFile(contentHash, sampleRate);
+    auto cacheDir = cacheFile.getParentDirectory();
+
+    if (!cacheDir.exists())
+        cacheDir.createDirectory();
+
+    // Write to a temporary file and move it into place, so a concurrent reader or
+    // a crash mid-write never sees a truncated entry
+    juce::TemporaryFile temp(cacheFile);
+
+    {
+        juce::FileOutputStream output(temp.getFile());
+        if (!output.openedOk())
+            return;
+
+        output.writeInt(fileMagic);
+        output.writeInt(fileVersion);
+        output.writeInt(convertedAudio.getNumChannels());
+        output.writeInt(convertedAudio.getNumSamples());
+        output.writeDouble(sampleRate);
+
+        for (int channel = 0; channel < convertedAudio.getNumChannels(); ++channel)
+            output.write(convertedAudio.getReadPointer(channel),
+                static_cast<size_t>(convertedAudio.getNumSamples()) * sizeof(float));
+
+        output.flush();
+        if (output.getStatus().failed())
+            return;
+    }
+
+    if (!temp.overwriteTargetFileWithTemporary())
+        DBG("Failed to write converted sample cache: " + cacheFile.getFullPathName());
+}
+
+juce::File ConvertedSampleCache::getCacheDirectory() const
+{
+    auto userAppData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+    return userAppData.getChildFile("MechaMovementSoundGenerator").getChildFile("SampleCache");
+}
+
+juce::File ConvertedSampleCache::getCacheFile(const juce::String& contentHash, double sampleRate) const
+{
+    return getCacheDirectory().getChildFile(contentHash + "_" + juce::String(juce::roundToInt(sampleRate)) + ".srcache");
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SampleData.h"
+
+// On-disk cache of samples already converted to a session rate, keyed by the hash
+// of the original file contents and the target rate. Lets later sessions skip the
+// offline resampling entirely. Safe to use from several loader threads at once.
+class ConvertedSampleCache
+{
+public:
+    ConvertedSampleCache() = default;
+
+    SampleData::Ptr load(const juce::String& contentHash, double sampleRate,
+        SampleData::StorageFormat format) const;
+    void store(const juce::String& contentHash, double sampleRate,
+        const juce::AudioBuffer<float>& convertedAudio) const;
+
+    juce::File getCacheDirectory() const;
+
+private:
+    juce::File getCacheFile(const juce::String& contentHash, double sampleRate) const;
+
+    static constexpr int fileMagic = 0x4352534d; // "MSRC"
+    static constexpr int fileVersion = 1;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConvertedSampleCache)
+};
@@ -0,0 +1,29 @@
+#include "CpuLoadMeter.h"
+
+void CpuLoadMeter::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    ticksPerSecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond());
+
+    average = 0.0f;
+    peak = 0.0f;
+    averageLoad.store(0.0f, std::memory_order_relaxed);
+    peakLoad.store(0.0f, std::memory_order_relaxed);
+}
+
+void CpuLoadMeter::addBlock(juce::int64 elapsedTicks, int numSamples)
+{
+    if (numSamples <= 0)
+        return;
+
+    auto budgetSeconds = numSamples / currentSampleRate;
+    auto load = static_cast<float>((static_cast<double>(elapsedTicks) / ticksPerSecond) / budgetSeconds);
+
+    auto coefficient = static_cast<float>(1.0 - std::exp(-budgetSeconds / averageTimeSeconds));
+    average += (load - average) * coefficient;
+
+    peak = juce::jmax(load, peak - static_cast<float>(peakFallPerSecond * budgetSeconds));
+
+    averageLoad.store(average, std::memory_order_relaxed);
+    peakLoad.store(peak, std::memory_order_relaxed);
+}
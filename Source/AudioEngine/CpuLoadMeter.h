@@ -0,0 +1,57 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Time spent in one stage of processBlock, as a fraction of the real-time budget
+// of the blocks it ran in (1.0 means the stage alone used the whole budget).
+//
+// Timed with juce::Time::getHighResolutionTicks(), the platform's monotonic
+// high-resolution counter. The audio thread keeps an exponential average and a
+// peak that falls back slowly, and publishes both through relaxed atomics, so
+// the editor and tests can read them from any thread.
+class CpuLoadMeter
+{
+public:
+    CpuLoadMeter() = default;
+
+    // Audio thread
+    void prepare(double sampleRate);
+    void addBlock(juce::int64 elapsedTicks, int numSamples);
+
+    // Any thread
+    float getAverage() const { return averageLoad.load(std::memory_order_relaxed); }
+    float getPeak() const { return peakLoad.load(std::memory_order_relaxed); }
+
+    // Audio thread helper: times the enclosing scope
+    class ScopedTimer
+    {
+    public:
+        ScopedTimer(CpuLoadMeter& meterToUse, int numSamplesInBlock)
+            : meter(meterToUse), numSamples(numSamplesInBlock), start(juce::Time::getHighResolutionTicks()) {}
+
+        ~ScopedTimer() { meter.addBlock(juce::Time::getHighResolutionTicks() - start, numSamples); }
+
+    private:
+        CpuLoadMeter& meter;
+        int numSamples;
+        juce::int64 start;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTimer)
+    };
+
+private:
+    static constexpr double averageTimeSeconds = 0.5;
+    static constexpr double peakFallPerSecond = 0.25;
+
+    double currentSampleRate = 44100.0;
+    double ticksPerSecond = 1.0;
+
+    // Audio thread state
+    float average = 0.0f;
+    float peak = 0.0f;
+
+    std::atomic<float> averageLoad{ 0.0f };
+    std::atomic<float> peakLoad{ 0.0f };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuLoadMeter)
+};
@@ -0,0 +1,421 @@
+#include "EmitterEngine.h"
+
+namespace
+{
+    constexpr float twoPi = juce::MathConstants<float>::twoPi;
+    constexpr float envelopeSeconds = 0.05f;
+
+    inline float signOf(float value)
+    {
+        return std::copysign(1.0f, value);
+    }
+
+    // Per-lane xorshift32 mapped to [-1, 1)
+    inline float nextNoise(juce::uint32& state)
+    {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return static_cast<float>(static_cast<juce::int32>(state)) * (1.0f / 2147483648.0f);
+    }
+
+    inline void setRotation(float frequency, double sampleRate, float& cosOut, float& sinOut)
+    {
+        auto angle = twoPi * frequency / static_cast<float>(sampleRate);
+        cosOut = std::cos(angle);
+        sinOut = std::sin(angle);
+    }
+
+    inline void rotate(float& re, float& im, float c, float s)
+    {
+        auto newRe = re * c - im * s;
+        im = re * s + im * c;
+        re = newRe;
+    }
+}
+
+//==============================================================================
+int EmitterEngine::addEmitter(const Params& newParams)
+{
+    const juce::SpinLock::ScopedLockType sl(controlLock);
+
+    reclaimFadedSlots();
+
+    auto slot = std::find(slotInUse.begin(), slotInUse.end(), false);
+    if (slot == slotInUse.end())
+        return -1;
+
+    Command command;
+    command.type = CommandType::add;
+    command.emitter = static_cast<int>(std::distance(slotInUse.begin(), slot));
+    command.params = newParams;
+
+    if (!pushCommand(command))
+        return -1;
+
+    *slot = true;
+    ++numSlotsInUse;
+    return command.emitter;
+}
+
+bool EmitterEngine::removeEmitter(int emitter)
+{
+    const juce::SpinLock::ScopedLockType sl(controlLock);
+
+    if (!isAddressable(emitter))
+        return false;
+
+    Command command;
+    command.type = CommandType::remove;
+    command.emitter = emitter;
+
+    if (!pushCommand(command))
+        return false;
+
+    // The slot stays taken until the audio thread has faded the voice out
+    slotRemoving[static_cast<size_t>(emitter)] = true;
+    --numSlotsInUse;
+    return true;
+}
+
+bool EmitterEngine::setParams(int emitter, const Params& newParams)
+{
+    const juce::SpinLock::ScopedLockType sl(controlLock);
+
+    if (!isAddressable(emitter))
+        return false;
+
+    Command command;
+    command.type = CommandType::setParams;
+    command.emitter = emitter;
+    command.params = newParams;
+    return pushCommand(command);
+}
+
+bool EmitterEngine::setMoving(int emitter, bool isMoving)
+{
+    const juce::SpinLock::ScopedLockType sl(controlLock);
+
+    if (!isAddressable(emitter))
+        return false;
+
+    Command command;
+    command.type = CommandType::setMoving;
+    command.emitter = emitter;
+    command.moving = isMoving;
+    return pushCommand(command);
+}
+
+int EmitterEngine::getNumEmitters() const
+{
+    const juce::SpinLock::ScopedLockType sl(controlLock);
+    return numSlotsInUse;
+}
+
+bool EmitterEngine::isAddressable(int emitter) const
+{
+    return juce::isPositiveAndBelow(emitter, maxEmitters)
+        && slotInUse[static_cast<size_t>(emitter)]
+        && !slotRemoving[static_cast<size_t>(emitter)];
+}
+
+void EmitterEngine::reclaimFadedSlots()
+{
+    for (size_t i = 0; i < slotInUse.size(); ++i)
+    {
+        if (slotRemoving[i] && fadeFinished[i].exchange(false, std::memory_order_acquire))
+        {
+            slotRemoving[i] = false;
+            slotInUse[i] = false;
+        }
+    }
+}
+
+bool EmitterEngine::pushCommand(const Command& command)
+{
+    const auto scope = commandFifo.write(1);
+    if (scope.blockSize1 + scope.blockSize2 == 0)
+        return false;
+
+    commands[static_cast<size_t>(scope.blockSize1 > 0 ? scope.startIndex1 : scope.startIndex2)] = command;
+    return true;
+}
+
+//==============================================================================
+void EmitterEngine::prepare(double sampleRate, int samplesPerBlock)
+{
+    currentSampleRate = sampleRate;
+    maxBlockSize = samplesPerBlock;
+
+    mixLeft.calloc(static_cast<size_t>(samplesPerBlock));
+    mixRight.calloc(static_cast<size_t>(samplesPerBlock));
+
+    // Roughly the 2 kHz low-pass of HydraulicHiss
+    hissCoefficient = 1.0f - std::exp(-twoPi * 2000.0f / static_cast<float>(sampleRate));
+    envelopeStep = 1.0f / (envelopeSeconds * static_cast<float>(sampleRate));
+
+    reset();
+}
+
+void EmitterEngine::reset()
+{
+    // Phasors start at angle zero; noise seeds differ per lane
+    for (int i = 0; i < maxEmitters; ++i)
+    {
+        for (auto* re : { &whineRe, &motorRe, &resRe, &cycleRe, &grindARe, &grindBRe })
+            (*re)[i] = 1.0f;
+
+        for (auto* lanes : { &whineIm, &motorIm, &resIm, &cycleIm, &grindAIm, &grindBIm,
+                             &hissState, &envelope, &gainLeft, &gainRight, &gainLeftStep, &gainRightStep })
+            (*lanes)[i] = 0.0f;
+
+        noiseState[static_cast<size_t>(i)] = 0x9e3779b9u * static_cast<juce::uint32>(i + 1);
+    }
+}
+
+void EmitterEngine::render(juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    handleCommands();
+
+    if (numLiveEmitters == 0 || buffer.getNumChannels() == 0)
+        return;
+
+    numSamples = juce::jmin(numSamples, buffer.getNumSamples());
+
+    for (int offset = 0; offset < numSamples; offset += maxBlockSize)
+    {
+        auto chunk = juce::jmin(maxBlockSize, numSamples - offset);
+
+        juce::FloatVectorOperations::clear(mixLeft.get(), chunk);
+        juce::FloatVectorOperations::clear(mixRight.get(), chunk);
+
+        for (int group = 0; group < numLaneGroups; ++group)
+        {
+            if (liveInGroup[static_cast<size_t>(group)] == 0)
+                continue;
+
+            updateCoefficients(group, chunk);
+            renderGroup(group, chunk);
+            retireFinishedEmitters(group);
+        }
+
+        if (buffer.getNumChannels() == 1)
+        {
+            buffer.addFrom(0, offset, mixLeft.get(), chunk, 0.5f);
+            buffer.addFrom(0, offset, mixRight.get(), chunk, 0.5f);
+        }
+        else
+        {
+            buffer.addFrom(0, offset, mixLeft.get(), chunk);
+            buffer.addFrom(1, offset, mixRight.get(), chunk);
+        }
+    }
+}
+
+void EmitterEngine::handleCommands()
+{
+    auto numReady = commandFifo.getNumReady();
+    if (numReady == 0)
+        return;
+
+    const auto scope = commandFifo.read(numReady);
+
+    auto handle = [this](int start, int size)
+    {
+        for (int i = start; i < start + size; ++i)
+        {
+            const auto& command = commands[static_cast<size_t>(i)];
+            auto emitter = command.emitter;
+            auto index = static_cast<size_t>(emitter);
+            auto group = static_cast<size_t>(emitter / laneGroupSize);
+
+            switch (command.type)
+            {
+            case CommandType::add:
+                if (!live[index])
+                {
+                    live[index] = true;
+                    ++liveInGroup[group];
+                    ++numLiveEmitters;
+                }
+
+                removing[index] = false;
+                gate[emitter] = 0.0f;
+                envelope[emitter] = 0.0f;
+                gainLeft[emitter] = 0.0f;
+                gainRight[emitter] = 0.0f;
+                applyParams(emitter, command.params);
+                break;
+
+            case CommandType::remove:
+                removing[index] = true;
+                gate[emitter] = 0.0f;
+                break;
+
+            case CommandType::setParams:
+                applyParams(emitter, command.params);
+                break;
+
+            case CommandType::setMoving:
+                if (!removing[index])
+                    gate[emitter] = command.moving ? 1.0f : 0.0f;
+                break;
+            }
+        }
+    };
+
+    handle(scope.startIndex1, scope.blockSize1);
+    handle(scope.startIndex2, scope.blockSize2);
+}
+
+void EmitterEngine::applyParams(int emitter, const Params& newParams)
+{
+    params[static_cast<size_t>(emitter)] = newParams;
+}
+
+void EmitterEngine::updateCoefficients(int group, int numSamples)
+{
+    auto invSamples = 1.0f / static_cast<float>(numSamples);
+
+    for (int i = group * laneGroupSize; i < (group + 1) * laneGroupSize; ++i)
+    {
+        const auto& p = params[static_cast<size_t>(i)];
+        auto servoSpeed = juce::jlimit(0.0f, 100.0f, p.servoSpeed) / 100.0f;
+        auto gearSpeed = juce::jlimit(0.1f, 10.0f, p.gearSpeed);
+        auto pressure = juce::jlimit(0.1f, 10.0f, p.hydraulicPressure);
+        auto roughness = juce::jlimit(0.1f, 2.0f, p.gearRoughness);
+        auto whine = juce::jlimit(0.0f, 1.0f, p.servoWhine);
+
+        // Same frequency laws as ServoWhine, HydraulicHiss and GearGrind
+        setRotation(800.0f + servoSpeed * 2000.0f, currentSampleRate, whineCos[i], whineSin[i]);
+        setRotation(100.0f + servoSpeed * 500.0f, currentSampleRate, motorCos[i], motorSin[i]);
+        setRotation(60.0f + servoSpeed * 200.0f, currentSampleRate, resCos[i], resSin[i]);
+        setRotation(2.0f + (pressure - 1.0f) * 0.5f, currentSampleRate, cycleCos[i], cycleSin[i]);
+        setRotation(80.0f + gearSpeed * 40.0f, currentSampleRate, grindACos[i], grindASin[i]);
+        setRotation((80.0f + gearSpeed * 40.0f) * 1.33f, currentSampleRate, grindBCos[i], grindBSin[i]);
+
+        // Keep the phasors on the unit circle
+        for (auto pair : { std::make_pair(&whineRe, &whineIm), std::make_pair(&motorRe, &motorIm),
+                           std::make_pair(&resRe, &resIm), std::make_pair(&cycleRe, &cycleIm),
+                           std::make_pair(&grindARe, &grindAIm), std::make_pair(&grindBRe, &grindBIm) })
+        {
+            auto& re = (*pair.first)[i];
+            auto& im = (*pair.second)[i];
+            auto magnitude = std::sqrt(re * re + im * im);
+            auto scale = magnitude > 0.0f ? 1.0f / magnitude : 1.0f;
+            re = magnitude > 0.0f ? re * scale : 1.0f;
+            im *= scale;
+        }
+
+        auto servoAmount = p.servoLevel * (0.5f + servoSpeed * 0.5f);
+        whineWeight[i] = servoAmount * whine * 0.4f;
+        motorWeight[i] = servoAmount * (1.0f - whine * 0.5f) * 0.15f;
+        resWeight[i] = servoAmount * 0.3f * 0.25f;
+
+        hissWeight[i] = p.hydraulicLevel * 0.6f * 0.3f * (0.5f + pressure / 10.0f * 0.5f);
+        cycleWeight[i] = p.hydraulicLevel * 0.3f * 0.4f;
+
+        grindWeight[i] = p.gearLevel * 0.4f * 0.7f;
+        squareWeight[i] = p.gearLevel * 0.4f * 0.2f * roughness;
+        noiseWeight[i] = p.gearLevel * roughness * 0.3f * (0.3f + gearSpeed / 10.0f * 0.7f);
+
+        // Constant power pan, ramped over the block
+        auto angle = (juce::jlimit(-1.0f, 1.0f, p.pan) + 1.0f) * juce::MathConstants<float>::pi * 0.25f;
+        auto targetGain = live[static_cast<size_t>(i)] ? p.gain : 0.0f;
+        gainLeftStep[i] = (targetGain * std::cos(angle) - gainLeft[i]) * invSamples;
+        gainRightStep[i] = (targetGain * std::sin(angle) - gainRight[i]) * invSamples;
+    }
+}
+
+void EmitterEngine::renderGroup(int group, int numSamples)
+{
+    const auto first = group * laneGroupSize;
+    auto* left = mixLeft.get();
+    auto* right = mixRight.get();
+
+    for (int sample = 0; sample < numSamples; ++sample)
+    {
+        // One output per lane rather than a running sum: a float reduction would
+        // tie the lanes together (compilers keep its order without fast-math),
+        // whereas with a fixed trip count, no branches and no cross-lane
+        // dependency this loop vectorises across lanes
+        alignas(32) std::array<float, laneGroupSize> laneLeft;
+        alignas(32) std::array<float, laneGroupSize> laneRight;
+
+        for (int lane = 0; lane < laneGroupSize; ++lane)
+        {
+            const auto i = first + lane;
+
+            rotate(whineRe[i], whineIm[i], whineCos[i], whineSin[i]);
+            rotate(motorRe[i], motorIm[i], motorCos[i], motorSin[i]);
+            rotate(resRe[i], resIm[i], resCos[i], resSin[i]);
+            rotate(cycleRe[i], cycleIm[i], cycleCos[i], cycleSin[i]);
+            rotate(grindARe[i], grindAIm[i], grindACos[i], grindASin[i]);
+            rotate(grindBRe[i], grindBIm[i], grindBCos[i], grindBSin[i]);
+
+            auto noiseA = nextNoise(noiseState[static_cast<size_t>(i)]);
+            auto noiseB = nextNoise(noiseState[static_cast<size_t>(i)]);
+
+            // Servo: whine, switching motor and resonance with its second harmonic
+            auto servo = whineIm[i] * whineWeight[i]
+                + signOf(motorIm[i]) * motorWeight[i]
+                + (resIm[i] + 0.6f * resIm[i] * resRe[i]) * resWeight[i];
+
+            // Hydraulic: low-passed noise over a slow pressure cycle
+            hissState[i] += (noiseA - hissState[i]) * hissCoefficient;
+            auto hydraulic = hissState[i] * hissWeight[i] + cycleIm[i] * cycleWeight[i];
+
+            // Gear: two meshing tones, their harsh square edges and grit
+            auto gear = (grindAIm[i] * 0.6f + grindBIm[i] * 0.4f) * grindWeight[i]
+                + (signOf(grindAIm[i]) + signOf(grindBIm[i])) * squareWeight[i]
+                + noiseB * noiseWeight[i];
+
+            auto level = envelope[i];
+            level += juce::jlimit(-envelopeStep, envelopeStep, gate[i] - level);
+            envelope[i] = level;
+
+            auto voice = (servo + hydraulic + gear) * level;
+
+            gainLeft[i] += gainLeftStep[i];
+            gainRight[i] += gainRightStep[i];
+
+            laneLeft[static_cast<size_t>(lane)] = voice * gainLeft[i];
+            laneRight[static_cast<size_t>(lane)] = voice * gainRight[i];
+        }
+
+        float sumLeft = 0.0f;
+        float sumRight = 0.0f;
+
+        for (int lane = 0; lane < laneGroupSize; ++lane)
+        {
+            sumLeft += laneLeft[static_cast<size_t>(lane)];
+            sumRight += laneRight[static_cast<size_t>(lane)];
+        }
+
+        left[sample] += sumLeft;
+        right[sample] += sumRight;
+    }
+}
+
+void EmitterEngine::retireFinishedEmitters(int group)
+{
+    for (int i = group * laneGroupSize; i < (group + 1) * laneGroupSize; ++i)
+    {
+        auto index = static_cast<size_t>(i);
+
+        if (live[index] && removing[index] && envelope[i] <= 0.0f)
+        {
+            live[index] = false;
+            removing[index] = false;
+            gainLeft[i] = 0.0f;
+            gainRight[i] = 0.0f;
+            gainLeftStep[i] = 0.0f;
+            gainRightStep[i] = 0.0f;
+            --liveInGroup[static_cast<size_t>(group)];
+            --numLiveEmitters;
+
+            // The control side can hand the slot out again
+            fadeFinished[index].store(true, std::memory_order_release);
+        }
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Many lightweight mech voices in one processor, for game scenes with dozens of
+// robots where a plugin instance per robot is too heavy.
+//
+// Each emitter is a simplified servo + hydraulic + gear voice. All emitter state
+// lives in structure-of-arrays form, one fixed array per field sized for
+// maxEmitters, so the per-sample kernel runs over groups of laneGroupSize
+// emitters with straight-line code the compiler turns into SIMD. Oscillators are
+// rotating phasors (coefficients updated once per block) and noise is a per-lane
+// xorshift, so there are no per-sample calls into the maths library. Groups with
+// no live emitter are skipped.
+//
+// Emitters are added, changed and removed from non-audio threads through a
+// command queue; nothing is allocated after prepare(). A removed emitter fades
+// out before its slot goes quiet, and the slot is only reused after that.
+class EmitterEngine
+{
+public:
+    static constexpr int maxEmitters = 128;
+    static constexpr int laneGroupSize = 8;
+    static constexpr int numLaneGroups = maxEmitters / laneGroupSize;
+
+    struct Params
+    {
+        float gain = 1.0f;
+        float pan = 0.0f;               // -1 left to 1 right
+
+        float servoLevel = 1.0f;
+        float servoSpeed = 20.0f;       // 0-100, as SERVO_SPEED
+        float servoWhine = 0.3f;        // 0-1
+
+        float hydraulicLevel = 1.0f;
+        float hydraulicPressure = 2.0f; // 0.1-10
+
+        float gearLevel = 1.0f;
+        float gearSpeed = 2.0f;         // 0.1-10
+        float gearRoughness = 0.5f;     // 0.1-2
+    };
+
+    EmitterEngine() = default;
+
+    // Control side, any non-audio thread. Each call queues one command and
+    // returns false (or -1) if the emitter does not exist or the queue is full.
+    int addEmitter(const Params& params);
+    bool removeEmitter(int emitter);
+    bool setParams(int emitter, const Params& params);
+    bool setMoving(int emitter, bool isMoving);
+    int getNumEmitters() const;
+
+    // Audio thread
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+    bool isActive() const { return numLiveEmitters > 0; }
+
+    // Adds the emitters into the first two channels of buffer (or the only one)
+    void render(juce::AudioBuffer<float>& buffer, int numSamples);
+
+private:
+    enum class CommandType
+    {
+        add,
+        remove,
+        setParams,
+        setMoving
+    };
+
+    struct Command
+    {
+        CommandType type = CommandType::add;
+        int emitter = 0;
+        Params params;
+        bool moving = false;
+    };
+
+    // One float per emitter, aligned for the widest vector unit in use
+    struct alignas(64) Lanes
+    {
+        float value[maxEmitters]{};
+
+        float& operator[](int i) { return value[i]; }
+        float operator[](int i) const { return value[i]; }
+    };
+
+    static constexpr int commandQueueSize = 1024;
+
+    bool isAddressable(int emitter) const;
+    void reclaimFadedSlots();
+    bool pushCommand(const Command& command);
+    void handleCommands();
+    void applyParams(int emitter, const Params& params);
+    void updateCoefficients(int group, int numSamples);
+    void renderGroup(int group, int numSamples);
+    void retireFinishedEmitters(int group);
+
+    // Control side bookkeeping, guarded by controlLock. A removed emitter's slot
+    // stays in use until the audio thread reports its fade has finished.
+    juce::SpinLock controlLock;
+    std::array<bool, maxEmitters> slotInUse{};
+    std::array<bool, maxEmitters> slotRemoving{};
+    int numSlotsInUse = 0;
+
+    // Audio -> control: set once a removed emitter has gone quiet
+    std::array<std::atomic<bool>, maxEmitters> fadeFinished{};
+
+    // Control -> audio
+    juce::AbstractFifo commandFifo{ commandQueueSize };
+    std::array<Command, commandQueueSize> commands;
+
+    // Audio thread state
+    double currentSampleRate = 44100.0;
+    int maxBlockSize = 0;
+    int numLiveEmitters = 0;
+    std::array<int, numLaneGroups> liveInGroup{};
+    std::array<bool, maxEmitters> live{};
+    std::array<bool, maxEmitters> removing{};
+    std::array<Params, maxEmitters> params{};
+
+    // Phasors: whine, motor, gear resonance, pressure cycle, grind 1 and 2
+    Lanes whineRe, whineIm, whineCos, whineSin;
+    Lanes motorRe, motorIm, motorCos, motorSin;
+    Lanes resRe, resIm, resCos, resSin;
+    Lanes cycleRe, cycleIm, cycleCos, cycleSin;
+    Lanes grindARe, grindAIm, grindACos, grindASin;
+    Lanes grindBRe, grindBIm, grindBCos, grindBSin;
+
+    // Per-block mix weights
+    Lanes whineWeight, motorWeight, resWeight;
+    Lanes hissWeight, cycleWeight;
+    Lanes grindWeight, squareWeight, noiseWeight;
+
+    // Hiss low-pass state and noise generators
+    Lanes hissState;
+    std::array<juce::uint32, maxEmitters> noiseState{};
+
+    // Gate envelope and output gains, ramped across each block
+    Lanes envelope, gate;
+    Lanes gainLeft, gainRight, gainLeftStep, gainRightStep;
+
+    float hissCoefficient = 0.0f;
+    float envelopeStep = 0.0f;
+
+    juce::HeapBlock<float> mixLeft, mixRight;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(EmitterEngine)
+};
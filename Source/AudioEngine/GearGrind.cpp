@@ -25,6 +25,11 @@ void GearGrind::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    enableIndex = BlockParameters::indexOf("GEAR_ENABLE");
+    gainIndex = BlockParameters::indexOf("GEAR_GAIN");
+    roughnessIndex = BlockParameters::indexOf("GEAR_ROUGHNESS");
+    speedIndex = BlockParameters::indexOf("GEAR_SPEED");
+
     // Prepare filters for gear sound shaping
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -75,18 +80,26 @@ void GearGrind::reset()
         tooth.engagement = 0.0f;
         tooth.isEngaged = false;
     }
+
+    random.setSeed(seed);
+}
+
+void GearGrind::setSeed(juce::int64 newSeed)
+{
+    seed = newSeed;
+    random.setSeed(seed);
 }
 
 void GearGrind::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-    juce::AudioProcessorValueTreeState& apvts)
+    const BlockParameters& parameters)
 {
     // Get parameters
-    bool enabled = *apvts.getRawParameterValue("GEAR_ENABLE");
+    bool enabled = parameters.get(enableIndex) >= 0.5f;
     if (!enabled) return;
 
-    float gain = *apvts.getRawParameterValue("GEAR_GAIN");
-    float roughness = *apvts.getRawParameterValue("GEAR_ROUGHNESS");
-    float speed = *apvts.getRawParameterValue("GEAR_SPEED");
+    float gain = parameters.get(gainIndex);
+    float roughness = parameters.get(roughnessIndex);
+    float speed = parameters.get(speedIndex);
 
     // Update smoothed parameters
     gainSmoother.setTargetValue(gain);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockParameters.h"
 
 class GearGrind
 {
@@ -11,7 +12,10 @@ public:
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-        juce::AudioProcessorValueTreeState& apvts);
+        const BlockParameters& parameters);
+
+    // Noise is drawn from this seed and reset() rewinds to it
+    void setSeed(juce::int64 newSeed);
 
 private:
     // Audio processing
@@ -32,6 +36,7 @@ private:
 
     // Noise generators
     juce::Random random;
+    juce::int64 seed = juce::Random::getSystemRandom().nextInt64();
 
     // Envelope for gear activation
     juce::ADSR gearEnvelope;
@@ -42,6 +47,12 @@ private:
     float currentRoughness = 0.5f;
     float currentSpeed = 2.0f;
 
+    // Schema positions of the parameters read each block, resolved in prepare()
+    int enableIndex = -1;
+    int gainIndex = -1;
+    int roughnessIndex = -1;
+    int speedIndex = -1;
+
     // Parameter smoothing
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::LinearSmoothedValue<float> roughnessSmoother;
@@ -72,5 +83,8 @@ private:
     void updateGearTeeth();
     float calculateGearEngagement();
 
+    // Drives the kernels above in Benchmarks/GeneratorKernelBenchmarks.cpp
+    friend struct GeneratorKernelAccess;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GearGrind)
 };
\ No newline at end of file
@@ -0,0 +1,185 @@
+#include "GranularEngine.h"
+
+GranularEngine::GranularEngine()
+{
+    // Precompute the grain window once
+    for (int i = 0; i <= windowTableSize; ++i)
+    {
+        auto phase = static_cast<float>(i) / windowTableSize;
+        windowTable[static_cast<size_t>(i)] = 0.5f - 0.5f * std::cos(2.0f * juce::MathConstants<float>::pi * phase);
+    }
+}
+
+GranularEngine::~GranularEngine()
+{
+}
+
+void GranularEngine::prepare(double sampleRate, int samplesPerBlock)
+{
+    currentSampleRate = sampleRate;
+    currentBlockSize = samplesPerBlock;
+
+    grainScratch.allocate(static_cast<size_t>(samplesPerBlock), true);
+    windowScratch.allocate(static_cast<size_t>(samplesPerBlock), true);
+
+    reset();
+}
+
+void GranularEngine::reset()
+{
+    for (auto& grain : grains)
+        grain.active = false;
+
+    numActiveGrains = 0;
+    gateOpen = false;
+    samplesUntilNextGrain = 0.0;
+    random.setSeed(seed);
+}
+
+void GranularEngine::setSeed(juce::int64 newSeed)
+{
+    seed = newSeed;
+    random.setSeed(seed);
+}
+
+void GranularEngine::noteOn(float notePitch, float velocity)
+{
+    gateOpen = true;
+    gatePitch = notePitch;
+    gateVelocity = velocity;
+    samplesUntilNextGrain = 0.0; // first grain starts immediately
+}
+
+void GranularEngine::noteOff()
+{
+    // Grains already running play out their window
+    gateOpen = false;
+}
+
+void GranularEngine::render(juce::AudioBuffer<float>& buffer, const SampleData& sample,
+    const Settings& settings, float gain)
+{
+    auto numSamples = buffer.getNumSamples();
+    jassert(numSamples <= currentBlockSize);
+
+    if (sample.isEmpty() || sample.isCompressed() || numSamples > currentBlockSize)
+        return;
+
+    if (gateOpen)
+        scheduleGrains(numSamples, sample, settings);
+
+    for (auto& grain : grains)
+    {
+        if (!grain.active)
+            continue;
+
+        renderGrain(grain, sample, buffer, gain * gateVelocity);
+
+        if (grain.samplesRemaining <= 0)
+        {
+            grain.active = false;
+            --numActiveGrains;
+        }
+    }
+}
+
+void GranularEngine::scheduleGrains(int numSamples, const SampleData& sample, const Settings& settings)
+{
+    auto interval = currentSampleRate / juce::jmax(0.1f, settings.density);
+
+    while (samplesUntilNextGrain < numSamples)
+    {
+        startGrain(static_cast<int>(samplesUntilNextGrain), sample, settings);
+        samplesUntilNextGrain += interval;
+    }
+
+    samplesUntilNextGrain -= numSamples;
+}
+
+void GranularEngine::startGrain(int offsetInBlock, const SampleData& sample, const Settings& settings)
+{
+    if (numActiveGrains >= maxGrains)
+        return; // pool exhausted; drop the grain rather than allocate
+
+    auto grainIt = std::find_if(grains.begin(), grains.end(), [](const Grain& g) { return !g.active; });
+    jassert(grainIt != grains.end());
+
+    auto& grain = *grainIt;
+    auto length = sample.getNumFrames();
+
+    auto grainSamples = juce::jmax(16, static_cast<int>(settings.sizeMs * 0.001 * currentSampleRate));
+
+    // Position with jitter, in source frames
+    auto jitter = (random.nextFloat() * 2.0f - 1.0f) * settings.positionJitter;
+    auto start = juce::jlimit(0.0f, 1.0f, settings.position + jitter) * static_cast<float>(length - 1);
+
+    // Pitch spray in semitones around the note and global pitch
+    auto spray = (random.nextFloat() * 2.0f - 1.0f) * settings.pitchSpray;
+    auto rate = gatePitch * settings.pitch * std::pow(2.0f, spray / 12.0f);
+
+    // Equal-power random pan for a wider texture
+    auto pan = random.nextFloat();
+
+    grain.active = true;
+    grain.sourcePosition = start;
+    grain.increment = rate;
+    grain.windowPhase = 0.0f;
+    grain.windowIncrement = static_cast<float>(windowTableSize) / static_cast<float>(grainSamples);
+    grain.samplesRemaining = grainSamples;
+    grain.startOffset = offsetInBlock;
+    grain.gainLeft = std::cos(pan * juce::MathConstants<float>::halfPi);
+    grain.gainRight = std::sin(pan * juce::MathConstants<float>::halfPi);
+
+    ++numActiveGrains;
+}
+
+void GranularEngine::renderGrain(Grain& grain, const SampleData& sample, juce::AudioBuffer<float>& buffer, float gain)
+{
+    auto numToRender = juce::jmin(buffer.getNumSamples() - grain.startOffset, grain.samplesRemaining);
+    auto lastFrame = sample.getNumFrames() - 1;
+    const auto* source = sample.getBuffer().getReadPointer(0);
+
+    // Gather pass: interpolated source frames and window values for this grain
+    auto position = grain.sourcePosition;
+    auto windowPhase = grain.windowPhase;
+
+    for (int i = 0; i < numToRender; ++i)
+    {
+        auto index = static_cast<int>(position);
+        float value = 0.0f;
+
+        if (index < lastFrame)
+        {
+            auto fraction = static_cast<float>(position - index);
+            value = source[index] + fraction * (source[index + 1] - source[index]);
+        }
+
+        auto windowIndex = juce::jmin(static_cast<int>(windowPhase), windowTableSize - 1);
+        auto windowFraction = windowPhase - static_cast<float>(windowIndex);
+        auto w0 = windowTable[static_cast<size_t>(windowIndex)];
+
+        grainScratch[i] = value;
+        windowScratch[i] = w0 + windowFraction * (windowTable[static_cast<size_t>(windowIndex + 1)] - w0);
+
+        position += grain.increment;
+        windowPhase += grain.windowIncrement;
+    }
+
+    // Vector pass: window and mix into the output with SIMD
+    juce::FloatVectorOperations::multiply(grainScratch.get(), windowScratch.get(), numToRender);
+
+    if (buffer.getNumChannels() == 1)
+    {
+        buffer.addFrom(0, grain.startOffset, grainScratch.get(), numToRender, gain);
+    }
+    else
+    {
+        buffer.addFrom(0, grain.startOffset, grainScratch.get(), numToRender, gain * grain.gainLeft);
+        buffer.addFrom(1, grain.startOffset, grainScratch.get(), numToRender, gain * grain.gainRight);
+    }
+
+    grain.sourcePosition = position;
+    grain.windowPhase = windowPhase;
+    grain.samplesRemaining -= numToRender;
+    grain.startOffset = 0;
+}
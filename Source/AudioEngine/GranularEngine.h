@@ -0,0 +1,82 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "SampleData.h"
+
+// Granular renderer used by SamplePlayback's granular mode. Grains come from a
+// fixed pool and are windowed from a precomputed table; nothing is allocated
+// after prepare(), so hundreds of overlapping grains can run on the audio thread.
+class GranularEngine
+{
+public:
+    struct Settings
+    {
+        float density = 20.0f;       // grains per second
+        float sizeMs = 80.0f;        // grain length
+        float position = 0.0f;       // 0-1 read position in the sample
+        float positionJitter = 0.0f; // 0-1 of the sample length
+        float pitchSpray = 0.0f;     // random detune range in semitones
+        float pitch = 1.0f;          // playback rate of every grain
+    };
+
+    GranularEngine();
+    ~GranularEngine();
+
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+
+    // Grain scatter is drawn from this seed and reset() rewinds to it
+    void setSeed(juce::int64 newSeed);
+
+    void noteOn(float notePitch, float velocity);
+    void noteOff();
+    bool isActive() const { return gateOpen || numActiveGrains > 0; }
+
+    // Adds this block's grains into buffer. Only float32 samples are granulated;
+    // compressed samples leave the buffer untouched.
+    void render(juce::AudioBuffer<float>& buffer, const SampleData& sample, const Settings& settings, float gain);
+
+    static constexpr int maxGrains = 256;
+    static constexpr int windowTableSize = 2048;
+
+private:
+    struct Grain
+    {
+        bool active = false;
+        double sourcePosition = 0.0;
+        double increment = 1.0;
+        float windowPhase = 0.0f;     // index into windowTable
+        float windowIncrement = 0.0f;
+        int samplesRemaining = 0;
+        int startOffset = 0;          // first sample in the current block
+        float gainLeft = 0.0f;
+        float gainRight = 0.0f;
+    };
+
+    double currentSampleRate = 44100.0;
+    int currentBlockSize = 512;
+
+    std::array<Grain, maxGrains> grains;
+    int numActiveGrains = 0;
+
+    // Hann window, one extra point so interpolation never wraps
+    std::array<float, windowTableSize + 1> windowTable;
+
+    // Per-grain scratch, sized in prepare()
+    juce::HeapBlock<float> grainScratch;
+    juce::HeapBlock<float> windowScratch;
+
+    juce::Random random;
+    juce::int64 seed = juce::Random::getSystemRandom().nextInt64();
+
+    bool gateOpen = false;
+    float gatePitch = 1.0f;
+    float gateVelocity = 1.0f;
+    double samplesUntilNextGrain = 0.0;
+
+    void scheduleGrains(int numSamples, const SampleData& sample, const Settings& settings);
+    void startGrain(int offsetInBlock, const SampleData& sample, const Settings& settings);
+    void renderGrain(Grain& grain, const SampleData& sample, juce::AudioBuffer<float>& buffer, float gain);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GranularEngine)
+};
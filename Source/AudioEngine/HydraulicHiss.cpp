@@ -19,6 +19,11 @@ void HydraulicHiss::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    enableIndex = BlockParameters::indexOf("HYDRAULIC_ENABLE");
+    gainIndex = BlockParameters::indexOf("HYDRAULIC_GAIN");
+    pressureIndex = BlockParameters::indexOf("HYDRAULIC_PRESSURE");
+    flowIndex = BlockParameters::indexOf("HYDRAULIC_FLOW");
+
     // Prepare filters for hydraulic sound shaping
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -55,18 +60,25 @@ void HydraulicHiss::reset()
     pressurePhase = 0.0f;
     flowPhase = 0.0f;
     isActive = false;
+    random.setSeed(seed);
+}
+
+void HydraulicHiss::setSeed(juce::int64 newSeed)
+{
+    seed = newSeed;
+    random.setSeed(seed);
 }
 
 void HydraulicHiss::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-    juce::AudioProcessorValueTreeState& apvts)
+    const BlockParameters& parameters)
 {
     // Get parameters
-    bool enabled = *apvts.getRawParameterValue("HYDRAULIC_ENABLE");
+    bool enabled = parameters.get(enableIndex) >= 0.5f;
     if (!enabled) return;
 
-    float gain = *apvts.getRawParameterValue("HYDRAULIC_GAIN");
-    float pressure = *apvts.getRawParameterValue("HYDRAULIC_PRESSURE");
-    float flow = *apvts.getRawParameterValue("HYDRAULIC_FLOW");
+    float gain = parameters.get(gainIndex);
+    float pressure = parameters.get(pressureIndex);
+    float flow = parameters.get(flowIndex);
 
     // Update smoothed parameters
     gainSmoother.setTargetValue(gain);
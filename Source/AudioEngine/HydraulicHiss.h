@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockParameters.h"
 
 class HydraulicHiss
 {
@@ -11,7 +12,10 @@ public:
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-        juce::AudioProcessorValueTreeState& apvts);
+        const BlockParameters& parameters);
+
+    // Noise is drawn from this seed and reset() rewinds to it
+    void setSeed(juce::int64 newSeed);
 
 private:
     // Audio processing
@@ -20,6 +24,7 @@ private:
 
     // Noise generators for hydraulic hiss
     juce::Random random;
+    juce::int64 seed = juce::Random::getSystemRandom().nextInt64();
     juce::dsp::IIR::Filter<float> lowPassFilter;
     juce::dsp::IIR::Filter<float> highPassFilter;
     juce::dsp::IIR::Filter<float> bandPassFilter;
@@ -37,6 +42,12 @@ private:
     float currentPressure = 0.0f;
     float currentFlow = 0.0f;
 
+    // Schema positions of the parameters read each block, resolved in prepare()
+    int enableIndex = -1;
+    int gainIndex = -1;
+    int pressureIndex = -1;
+    int flowIndex = -1;
+
     // Parameter smoothing
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::LinearSmoothedValue<float> pressureSmoother;
@@ -50,5 +61,8 @@ private:
     float generatePressureCycle();
     float generateFlowNoise();
 
+    // Drives the kernels above in Benchmarks/GeneratorKernelBenchmarks.cpp
+    friend struct GeneratorKernelAccess;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(HydraulicHiss)
 };
\ No newline at end of file
@@ -0,0 +1,69 @@
+#include "LevelMeter.h"
+
+namespace
+{
+    // Four running sums so the loop vectorises without relaxed float maths
+    float sumOfSquares(const float* data, int numSamples)
+    {
+        float sums[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+        int i = 0;
+
+        for (; i + 4 <= numSamples; i += 4)
+            for (int lane = 0; lane < 4; ++lane)
+                sums[lane] += data[i + lane] * data[i + lane];
+
+        for (; i < numSamples; ++i)
+            sums[0] += data[i] * data[i];
+
+        return (sums[0] + sums[1]) + (sums[2] + sums[3]);
+    }
+}
+
+void LevelMeter::prepare(double sampleRate)
+{
+    currentSampleRate = sampleRate;
+    reset();
+}
+
+void LevelMeter::reset()
+{
+    heldPeak = 0.0f;
+    meanSquare = 0.0f;
+    peakLevel.store(0.0f, std::memory_order_relaxed);
+    rmsLevel.store(0.0f, std::memory_order_relaxed);
+}
+
+void LevelMeter::measure(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    auto numChannels = buffer.getNumChannels();
+    if (numSamples <= 0 || numChannels == 0)
+        return;
+
+    float blockPeak = 0.0f;
+    float blockSquares = 0.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* data = buffer.getReadPointer(channel);
+        auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+
+        blockPeak = juce::jmax(blockPeak, -range.getStart(), range.getEnd());
+        blockSquares += sumOfSquares(data, numSamples);
+    }
+
+    auto blockSeconds = numSamples / currentSampleRate;
+
+    // Peak falls at a constant dB rate, RMS settles with a one-pole average
+    auto fall = static_cast<float>(juce::Decibels::decibelsToGain(-peakFallDbPerSecond * blockSeconds));
+    heldPeak = juce::jmax(blockPeak, heldPeak * fall);
+
+    auto blockMeanSquare = blockSquares / static_cast<float>(numSamples * numChannels);
+    auto coefficient = static_cast<float>(1.0 - std::exp(-blockSeconds / rmsTimeSeconds));
+    meanSquare += (blockMeanSquare - meanSquare) * coefficient;
+
+    peakLevel.store(heldPeak, std::memory_order_relaxed);
+    rmsLevel.store(std::sqrt(meanSquare), std::memory_order_relaxed);
+
+    if (blockPeak >= 1.0f)
+        clipped.store(true, std::memory_order_relaxed);
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Peak and RMS level of one bus, measured on the audio thread and read from any
+// other thread without locking.
+//
+// The audio thread owns the ballistics: the peak falls back at a fixed rate and
+// the RMS is an exponential average, so a reader polling at UI rate still sees
+// short transients between polls. Each value is a single float published with a
+// relaxed store; readers may see peak and RMS from neighbouring blocks, which a
+// meter cannot show anyway.
+class LevelMeter
+{
+public:
+    LevelMeter() = default;
+
+    // Audio thread
+    void prepare(double sampleRate);
+    void reset();
+    void measure(const juce::AudioBuffer<float>& buffer, int numSamples);
+
+    // Any thread; linear gain
+    float getPeak() const { return peakLevel.load(std::memory_order_relaxed); }
+    float getRms() const { return rmsLevel.load(std::memory_order_relaxed); }
+
+    // Latched once a sample reaches full scale, until cleared
+    bool hasClipped() const { return clipped.load(std::memory_order_relaxed); }
+    void clearClip() { clipped.store(false, std::memory_order_relaxed); }
+
+private:
+    static constexpr double peakFallDbPerSecond = 24.0;
+    static constexpr double rmsTimeSeconds = 0.3;
+
+    double currentSampleRate = 44100.0;
+
+    // Audio thread state
+    float heldPeak = 0.0f;
+    float meanSquare = 0.0f;
+
+    std::atomic<float> peakLevel{ 0.0f };
+    std::atomic<float> rmsLevel{ 0.0f };
+    std::atomic<bool> clipped{ false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeter)
+};
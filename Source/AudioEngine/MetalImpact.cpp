@@ -19,6 +19,11 @@ void MetalImpact::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    enableIndex = BlockParameters::indexOf("METAL_ENABLE");
+    gainIndex = BlockParameters::indexOf("METAL_GAIN");
+    resonanceIndex = BlockParameters::indexOf("METAL_RESONANCE");
+    decayIndex = BlockParameters::indexOf("METAL_DECAY");
+
     // Prepare filters for metallic character
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -36,6 +41,8 @@ void MetalImpact::prepare(double sampleRate, int samplesPerBlock)
 
     // Prepare envelope
     impactEnvelope.setSampleRate(sampleRate);
+    minImpactInterval = static_cast<juce::int64>(minImpactIntervalSeconds * sampleRate);
+    lastImpactSample = sampleClock - minImpactInterval;
 
     // Initialize smoothers
     gainSmoother.reset(sampleRate, 0.01); // 10ms smoothing
@@ -57,7 +64,9 @@ void MetalImpact::reset()
     impactEnvelope.reset();
     isActive = false;
     impactCounter = 0;
-    lastImpactTime = 0;
+    sampleClock = 0;
+    lastImpactSample = -minImpactInterval;
+    random.setSeed(seed);
 
     for (auto& osc : resonantOscillators)
     {
@@ -65,16 +74,27 @@ void MetalImpact::reset()
     }
 }
 
+void MetalImpact::setSeed(juce::int64 newSeed)
+{
+    seed = newSeed;
+    random.setSeed(seed);
+}
+
 void MetalImpact::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-    juce::AudioProcessorValueTreeState& apvts)
+    const BlockParameters& parameters)
 {
     // Get parameters
-    bool enabled = *apvts.getRawParameterValue("METAL_ENABLE");
+    bool enabled = parameters.get(enableIndex) >= 0.5f;
+
+    // The clock runs while disabled so the impact spacing stays in real time
+    auto blockStart = sampleClock;
+    sampleClock += buffer.getNumSamples();
+
     if (!enabled) return;
 
-    float gain = *apvts.getRawParameterValue("METAL_GAIN");
-    float resonance = *apvts.getRawParameterValue("METAL_RESONANCE");
-    float decay = *apvts.getRawParameterValue("METAL_DECAY");
+    float gain = parameters.get(gainIndex);
+    float resonance = parameters.get(resonanceIndex);
+    float decay = parameters.get(decayIndex);
 
     // Update smoothed parameters
     gainSmoother.setTargetValue(gain);
@@ -87,11 +107,12 @@ void MetalImpact::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffe
         auto message = metadata.getMessage();
         if (message.isNoteOn())
         {
-            processMidiNote(message.getNoteNumber(), true, message.getFloatVelocity());
+            processMidiNote(message.getNoteNumber(), true, message.getFloatVelocity(),
+                blockStart + metadata.samplePosition);
         }
         else if (message.isNoteOff())
         {
-            processMidiNote(message.getNoteNumber(), false, 0.0f);
+            processMidiNote(message.getNoteNumber(), false, 0.0f, blockStart + metadata.samplePosition);
         }
     }
 
@@ -137,18 +158,17 @@ void MetalImpact::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffe
     resonantFilter2.process(context);
 }
 
-void MetalImpact::processMidiNote(int midiNote, bool isNoteOn, float velocity)
+void MetalImpact::processMidiNote(int midiNote, bool isNoteOn, float velocity, juce::int64 eventSample)
 {
     // Map MIDI notes to metal impacts
     // E3 (64) and above trigger metal impacts
     if (midiNote >= 64 && isNoteOn)
     {
         // Prevent too rapid impacts
-        juce::uint32 currentTime = juce::Time::getMillisecondCounter();
-        if (currentTime - lastImpactTime >= minImpactInterval)
+        if (eventSample - lastImpactSample >= minImpactInterval)
         {
             triggerImpact(velocity, midiNote);
-            lastImpactTime = currentTime;
+            lastImpactSample = eventSample;
         }
     }
 }
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockParameters.h"
 
 class MetalImpact
 {
@@ -11,7 +12,10 @@ public:
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-        juce::AudioProcessorValueTreeState& apvts);
+        const BlockParameters& parameters);
+
+    // Noise is drawn from this seed and reset() rewinds to it
+    void setSeed(juce::int64 newSeed);
 
 private:
     // Audio processing
@@ -46,6 +50,7 @@ private:
 
     // Noise source for initial impact transient
     juce::Random random;
+    juce::int64 seed = juce::Random::getSystemRandom().nextInt64();
 
     // Internal state
     bool isActive = false;
@@ -53,17 +58,25 @@ private:
     float currentDecay = 0.0f;
     int impactCounter = 0;
 
+    // Schema positions of the parameters read each block, resolved in prepare()
+    int enableIndex = -1;
+    int gainIndex = -1;
+    int resonanceIndex = -1;
+    int decayIndex = -1;
+
     // Parameter smoothing
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::LinearSmoothedValue<float> resonanceSmoother;
     juce::LinearSmoothedValue<float> decaySmoother;
 
-    // Impact timing
-    juce::uint32 lastImpactTime = 0;
-    const juce::uint32 minImpactInterval = 100; // Minimum ms between impacts
+    // Impact timing, counted in samples so renders are repeatable
+    juce::int64 sampleClock = 0;
+    juce::int64 lastImpactSample = 0;
+    juce::int64 minImpactInterval = 0;
+    static constexpr double minImpactIntervalSeconds = 0.1; // Minimum time between impacts
 
     // MIDI handling
-    void processMidiNote(int midiNote, bool isNoteOn, float velocity);
+    void processMidiNote(int midiNote, bool isNoteOn, float velocity, juce::int64 eventSample);
 
     // Sound generation
     void triggerImpact(float velocity, int noteNumber);
@@ -74,5 +87,8 @@ private:
     float getFrequencyForNote(int noteNumber);
     void updateFilterFrequencies();
 
+    // Drives the kernels above in Benchmarks/GeneratorKernelBenchmarks.cpp
+    friend struct GeneratorKernelAccess;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MetalImpact)
 };
\ No newline at end of file
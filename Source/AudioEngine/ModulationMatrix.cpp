@@ -0,0 +1,320 @@
+#include "ModulationMatrix.h"
+
+namespace
+{
+    const juce::Identifier routeType("ROUTE");
+    const juce::Identifier sourceProperty("source");
+    const juce::Identifier destinationProperty("destination");
+    const juce::Identifier depthProperty("depth");
+    const juce::Identifier curveProperty("curve");
+    const juce::Identifier lfo1RateProperty("lfo1Rate");
+    const juce::Identifier lfo2RateProperty("lfo2Rate");
+
+    constexpr float defaultLfoRates[] = { 0.5f, 2.0f };
+}
+
+const juce::Identifier ModulationMatrix::stateType("MODULATION");
+
+ModulationMatrix::ModulationMatrix(juce::AudioProcessorValueTreeState& vts)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+    {
+        auto* parameter = vts.getParameter(PresetSchema::parameters[i].parameterId);
+
+        if (parameter != nullptr)
+            modulatable[i] = !parameter->isDiscrete() && !parameter->isBoolean();
+    }
+
+    macroIndices = { PresetSchema::indexOf("MACRO_1"), PresetSchema::indexOf("MACRO_2"),
+                     PresetSchema::indexOf("MACRO_3"), PresetSchema::indexOf("MACRO_4") };
+
+    for (int lfo = 0; lfo < numLfos; ++lfo)
+        lfoRates[static_cast<size_t>(lfo)].store(defaultLfoRates[lfo]);
+
+    setRoutes(getDefaultRoutes());
+}
+
+ModulationMatrix::~ModulationMatrix()
+{
+}
+
+int ModulationMatrix::setRoutes(const std::vector<Route>& newRoutes)
+{
+    auto next = std::make_unique<Table>();
+    std::array<int, PresetSchema::numParameters> slotForParameter;
+    slotForParameter.fill(-1);
+
+    std::vector<Route> kept;
+
+    // Grouped by curve so each curve is one straight-line pass
+    for (int curve = 0; curve < numCurves; ++curve)
+    {
+        next->curveStart[static_cast<size_t>(curve)] = next->numRoutes;
+
+        for (const auto& route : newRoutes)
+        {
+            if (static_cast<int>(route.curve) != curve || next->numRoutes == maxRoutes)
+                continue;
+
+            auto index = PresetSchema::indexOf(route.destination);
+            if (index < 0 || !modulatable[index] || !juce::isPositiveAndBelow(static_cast<int>(route.source), numSources))
+                continue;
+
+            auto& slot = slotForParameter[static_cast<size_t>(index)];
+            if (slot < 0)
+            {
+                slot = next->numDestinations++;
+                next->parameter[static_cast<size_t>(slot)] = index;
+                next->minValue[static_cast<size_t>(slot)] = PresetSchema::parameters[index].minValue;
+                next->maxValue[static_cast<size_t>(slot)] = PresetSchema::parameters[index].maxValue;
+            }
+
+            const auto& range = PresetSchema::parameters[index];
+            auto r = static_cast<size_t>(next->numRoutes++);
+            next->source[r] = static_cast<int>(route.source);
+            next->destination[r] = slot;
+            next->depth[r] = juce::jlimit(-1.0f, 1.0f, route.depth) * (range.maxValue - range.minValue);
+
+            kept.push_back(route);
+        }
+    }
+
+    next->curveStart[numCurves] = next->numRoutes;
+
+    // Only succeeds while the audio thread is not holding the current table
+    auto* expected = ownedTable.get();
+    while (!tableSlot.compare_exchange_weak(expected, next.get(), std::memory_order_acq_rel))
+    {
+        expected = ownedTable.get();
+        juce::Thread::yield();
+    }
+
+    ownedTable = std::move(next);
+
+    auto numKept = static_cast<int>(kept.size());
+
+    {
+        const juce::ScopedLock sl(routesLock);
+        routes = std::move(kept);
+    }
+
+    if (onChanged != nullptr)
+        onChanged();
+
+    return numKept;
+}
+
+std::vector<ModulationMatrix::Route> ModulationMatrix::getRoutes() const
+{
+    const juce::ScopedLock sl(routesLock);
+    return routes;
+}
+
+std::vector<ModulationMatrix::Route> ModulationMatrix::getDefaultRoutes()
+{
+    return {
+        // Movement intensity
+        { macro1, "HYDRAULIC_PRESSURE", 0.4f, Curve::linear },
+        { macro1, "SERVO_SPEED",        0.5f, Curve::linear },
+
+        // Mechanical stress
+        { macro2, "GEAR_ROUGHNESS",     0.5f, Curve::linear },
+        { macro2, "METAL_RESONANCE",    0.4f, Curve::linear },
+
+        // Impact force
+        { macro3, "METAL_GAIN",         0.5f, Curve::exponential },
+        { macro3, "METAL_DECAY",        0.3f, Curve::linear },
+
+        // System load
+        { macro4, "SERVO_WHINE",        0.4f, Curve::linear },
+        { macro4, "GEAR_SPEED",         0.3f, Curve::linear },
+
+        // The mod wheel used to drive movement intensity
+        { modWheel, "HYDRAULIC_PRESSURE", 0.4f, Curve::linear },
+        { modWheel, "SERVO_SPEED",        0.5f, Curve::linear },
+    };
+}
+
+void ModulationMatrix::setLfoRate(int lfo, float hz)
+{
+    if (!juce::isPositiveAndBelow(lfo, numLfos))
+        return;
+
+    lfoRates[static_cast<size_t>(lfo)].store(juce::jmax(0.0f, hz));
+
+    if (onChanged != nullptr)
+        onChanged();
+}
+
+float ModulationMatrix::getLfoRate(int lfo) const
+{
+    return juce::isPositiveAndBelow(lfo, numLfos) ? lfoRates[static_cast<size_t>(lfo)].load() : 0.0f;
+}
+
+juce::ValueTree ModulationMatrix::createState() const
+{
+    juce::ValueTree state(stateType, { { lfo1RateProperty, getLfoRate(0) }, { lfo2RateProperty, getLfoRate(1) } });
+
+    for (const auto& route : getRoutes())
+        state.appendChild(juce::ValueTree(routeType, { { sourceProperty, static_cast<int>(route.source) },
+                                                       { destinationProperty, route.destination },
+                                                       { depthProperty, route.depth },
+                                                       { curveProperty, static_cast<int>(route.curve) } }), nullptr);
+
+    return state;
+}
+
+void ModulationMatrix::restoreState(const juce::ValueTree& state)
+{
+    if (!state.hasType(stateType))
+    {
+        for (int lfo = 0; lfo < numLfos; ++lfo)
+            lfoRates[static_cast<size_t>(lfo)].store(defaultLfoRates[lfo]);
+
+        setRoutes(getDefaultRoutes());
+        return;
+    }
+
+    lfoRates[0].store(juce::jmax(0.0f, static_cast<float>(state.getProperty(lfo1RateProperty, defaultLfoRates[0]))));
+    lfoRates[1].store(juce::jmax(0.0f, static_cast<float>(state.getProperty(lfo2RateProperty, defaultLfoRates[1]))));
+
+    // setRoutes() drops anything out of range
+    std::vector<Route> restored;
+
+    for (const auto& child : state)
+    {
+        if (!child.hasType(routeType))
+            continue;
+
+        Route route;
+        route.source = static_cast<Source>(static_cast<int>(child[sourceProperty]));
+        route.destination = child[destinationProperty].toString();
+        route.depth = static_cast<float>(child[depthProperty]);
+        route.curve = static_cast<Curve>(juce::jlimit(0, numCurves - 1, static_cast<int>(child[curveProperty])));
+        restored.push_back(route);
+    }
+
+    setRoutes(restored);
+}
+
+//==============================================================================
+void ModulationMatrix::prepare(double sampleRate, int samplesPerBlock)
+{
+    juce::ignoreUnused(samplesPerBlock);
+    currentSampleRate = sampleRate;
+    reset();
+}
+
+void ModulationMatrix::reset()
+{
+    // Every source starts from rest, so what plays next does not depend on
+    // what played before
+    lfoPhases.fill(0.0);
+    sourceValues.fill(0.0f);
+}
+
+void ModulationMatrix::process(const juce::AudioBuffer<float>& input, const juce::MidiBuffer& midiMessages, int numSamples,
+    BlockParameters& parameters)
+{
+    updateSources(input, midiMessages, numSamples, parameters);
+
+    auto* table = tableSlot.exchange(nullptr, std::memory_order_acquire);
+    if (table == nullptr)
+        return;
+
+    evaluate(*table, parameters);
+    tableSlot.store(table, std::memory_order_release);
+}
+
+void ModulationMatrix::followOutput(const juce::AudioBuffer<float>& output, int numSamples)
+{
+    sourceValues[outputFollower] = follow(sourceValues[outputFollower], getBlockPeak(output, numSamples), numSamples);
+}
+
+void ModulationMatrix::updateSources(const juce::AudioBuffer<float>& input, const juce::MidiBuffer& midiMessages, int numSamples,
+    const BlockParameters& parameters)
+{
+    for (size_t i = 0; i < macroIndices.size(); ++i)
+        sourceValues[macro1 + i] = macroIndices[i] >= 0 ? parameters.get(macroIndices[i]) : 0.0f;
+
+    for (const auto metadata : midiMessages)
+    {
+        const auto message = metadata.getMessage();
+
+        if (message.isController() && message.getControllerNumber() == 1)
+            sourceValues[modWheel] = message.getControllerValue() / 127.0f;
+        else if (message.isNoteOn())
+            sourceValues[velocity] = message.getFloatVelocity();
+    }
+
+    // LFOs are sampled at the start of the block
+    auto lfo1Phase = static_cast<float>(lfoPhases[0]);
+    auto lfo2Phase = static_cast<float>(lfoPhases[1]);
+    sourceValues[lfo1] = std::sin(juce::MathConstants<float>::twoPi * lfo1Phase);
+    sourceValues[lfo2] = 1.0f - 4.0f * std::abs(lfo2Phase - 0.5f);
+
+    for (size_t i = 0; i < lfoPhases.size(); ++i)
+    {
+        lfoPhases[i] += lfoRates[i].load(std::memory_order_relaxed) * numSamples / currentSampleRate;
+        lfoPhases[i] -= std::floor(lfoPhases[i]);
+    }
+
+    sourceValues[inputFollower] = follow(sourceValues[inputFollower], getBlockPeak(input, numSamples), numSamples);
+}
+
+void ModulationMatrix::evaluate(const Table& table, BlockParameters& parameters)
+{
+    const auto numRoutes = table.numRoutes;
+    auto* values = routeValues.data();
+
+    // Gather
+    for (int r = 0; r < numRoutes; ++r)
+        values[r] = sourceValues[static_cast<size_t>(table.source[static_cast<size_t>(r)])];
+
+    // Shape, one branch-free loop per curve; each keeps the sign of x
+    auto runCurve = [&table, values](Curve curve, auto&& shape)
+    {
+        auto c = static_cast<size_t>(curve);
+        for (int r = table.curveStart[c]; r < table.curveStart[c + 1]; ++r)
+            values[r] = shape(values[r]);
+    };
+
+    runCurve(Curve::exponential, [](float x) { return x * std::abs(x); });
+    runCurve(Curve::logarithmic, [](float x) { return x * (2.0f - std::abs(x)); });
+    runCurve(Curve::sCurve, [](float x) { return x * std::abs(x) * (3.0f - 2.0f * std::abs(x)); });
+
+    // Scale
+    juce::FloatVectorOperations::multiply(values, table.depth.data(), numRoutes);
+
+    // Sum per destination
+    std::fill(offsets.begin(), offsets.begin() + table.numDestinations, 0.0f);
+
+    for (int r = 0; r < numRoutes; ++r)
+        offsets[static_cast<size_t>(table.destination[static_cast<size_t>(r)])] += values[r];
+
+    // Apply
+    for (int slot = 0; slot < table.numDestinations; ++slot)
+    {
+        auto s = static_cast<size_t>(slot);
+        auto index = table.parameter[s];
+        parameters.set(index, juce::jlimit(table.minValue[s], table.maxValue[s], parameters.get(index) + offsets[s]));
+    }
+}
+
+float ModulationMatrix::getBlockPeak(const juce::AudioBuffer<float>& buffer, int numSamples)
+{
+    float peak = 0.0f;
+    numSamples = juce::jmin(numSamples, buffer.getNumSamples());
+
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel)
+        peak = juce::jmax(peak, buffer.getMagnitude(channel, 0, numSamples));
+
+    return juce::jmin(peak, 1.0f);
+}
+
+float ModulationMatrix::follow(float current, float peak, int numSamples) const
+{
+    auto seconds = peak > current ? followerAttackSeconds : followerReleaseSeconds;
+    auto coefficient = 1.0f - std::exp(-static_cast<float>(numSamples / (seconds * currentSampleRate)));
+    return current + (peak - current) * coefficient;
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "BlockParameters.h"
+
+// Routes modulation sources (macros, mod wheel, velocity, LFOs and envelope
+// followers) to any continuous schema parameter, each route with a depth and a
+// response curve.
+//
+// Routes are compiled on the message thread into a flat table: one entry per
+// route holding a source index, a destination slot and a depth already scaled to
+// the destination's range, sorted by curve. The audio thread evaluates the whole
+// table once per block in a few straight-line passes (gather sources, shape per
+// curve group, scale, sum per destination), so hundreds of routes cost little.
+//
+// The offsets are added to the block's BlockParameters, which the generators
+// read; the parameters themselves are never touched, so the host and saved
+// state keep the unmodulated values. The routes and LFO rates are part of the
+// session state.
+class ModulationMatrix
+{
+public:
+    enum Source
+    {
+        macro1,
+        macro2,
+        macro3,
+        macro4,
+        modWheel,
+        velocity,
+        lfo1,
+        lfo2,
+        inputFollower,
+        outputFollower,
+        numSources
+    };
+
+    // Shapes applied to the source value; all keep the sign, so bipolar sources
+    // (the LFOs, -1 to 1) stay bipolar
+    enum class Curve
+    {
+        linear,
+        exponential,
+        logarithmic,
+        sCurve
+    };
+
+    static constexpr int numCurves = 4;
+
+    struct Route
+    {
+        Source source = macro1;
+        juce::String destination;   // parameter ID
+        float depth = 0.0f;         // -1 to 1, in units of the destination's range
+        Curve curve = Curve::linear;
+    };
+
+    static constexpr int maxRoutes = 512;
+    static constexpr int numLfos = 2;
+
+    explicit ModulationMatrix(juce::AudioProcessorValueTreeState& vts);
+    ~ModulationMatrix();
+
+    // Message thread. Compiles and publishes the routes, replacing the current
+    // ones. Routes to unknown or discrete parameters, or beyond maxRoutes, are
+    // dropped; returns how many were kept.
+    int setRoutes(const std::vector<Route>& routes);
+    std::vector<Route> getRoutes() const;
+
+    // The macro assignments of the original layout
+    static std::vector<Route> getDefaultRoutes();
+
+    // Any thread. LFO 1 is a sine, LFO 2 a triangle.
+    void setLfoRate(int lfo, float hz);
+    float getLfoRate(int lfo) const;
+
+    // Routes and LFO rates, for the session state. Restoring an invalid tree
+    // goes back to the default routes.
+    juce::ValueTree createState() const;
+    void restoreState(const juce::ValueTree& state);
+
+    static const juce::Identifier stateType;
+
+    // Called on the thread that changed the routes or LFO rates
+    std::function<void()> onChanged;
+
+    // Audio thread
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+
+    // Reads this block's sources from the input audio, MIDI and macros, then
+    // adds the modulation to parameters
+    void process(const juce::AudioBuffer<float>& input, const juce::MidiBuffer& midiMessages, int numSamples,
+        BlockParameters& parameters);
+
+    // Feeds the output envelope follower, for the next block
+    void followOutput(const juce::AudioBuffer<float>& output, int numSamples);
+
+private:
+    struct Table
+    {
+        int numRoutes = 0;
+        int numDestinations = 0;
+
+        // Per route, sorted by curve; curveStart[c] is the first route of curve c
+        std::array<int, maxRoutes> source{};
+        std::array<int, maxRoutes> destination{};
+        std::array<float, maxRoutes> depth{};
+        std::array<int, numCurves + 1> curveStart{};
+
+        // Per destination slot
+        std::array<int, PresetSchema::numParameters> parameter{};
+        std::array<float, PresetSchema::numParameters> minValue{};
+        std::array<float, PresetSchema::numParameters> maxValue{};
+    };
+
+    void updateSources(const juce::AudioBuffer<float>& input, const juce::MidiBuffer& midiMessages, int numSamples,
+        const BlockParameters& parameters);
+    void evaluate(const Table& table, BlockParameters& parameters);
+    static float getBlockPeak(const juce::AudioBuffer<float>& buffer, int numSamples);
+    float follow(float current, float peak, int numSamples) const;
+
+    // Resolved once; indexed in schema order
+    std::array<bool, PresetSchema::numParameters> modulatable{};
+    std::array<int, 4> macroIndices{};
+
+    // Message thread
+    std::vector<Route> routes;
+    mutable juce::CriticalSection routesLock;
+    std::unique_ptr<Table> ownedTable;
+
+    // Holds ownedTable except while the audio thread is evaluating it
+    std::atomic<Table*> tableSlot{ nullptr };
+
+    std::array<std::atomic<float>, numLfos> lfoRates;
+
+    // Audio thread state
+    double currentSampleRate = 44100.0;
+    std::array<float, numSources> sourceValues{};
+    std::array<double, numLfos> lfoPhases{};
+    static constexpr float followerAttackSeconds = 0.01f;
+    static constexpr float followerReleaseSeconds = 0.2f;
+
+    // Evaluation scratch
+    std::array<float, maxRoutes> routeValues{};
+    std::array<float, PresetSchema::numParameters> offsets{};
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulationMatrix)
+};
@@ -0,0 +1,536 @@
+#include "MovementSequencer.h"
+
+namespace
+{
+    const juce::Identifier eventType("EVENT");
+    const juce::Identifier nameProperty("name");
+    const juce::Identifier lengthProperty("lengthBeats");
+    const juce::Identifier loopProperty("loop");
+    const juce::Identifier beatProperty("beat");
+    const juce::Identifier typeProperty("type");
+    const juce::Identifier targetProperty("target");
+    const juce::Identifier noteProperty("note");
+    const juce::Identifier velocityProperty("velocity");
+    const juce::Identifier parameterProperty("parameter");
+    const juce::Identifier valueProperty("value");
+    const juce::Identifier rampBeatsProperty("rampBeats");
+    const juce::Identifier shapeProperty("shape");
+}
+
+const juce::Identifier MovementSequencer::stateType("SEQUENCE");
+
+MovementSequencer::MovementSequencer(juce::AudioProcessorValueTreeState& vts)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+    {
+        auto* parameter = vts.getParameter(PresetSchema::parameters[i].parameterId);
+
+        if (parameter == nullptr)
+            continue;
+
+        known[i] = true;
+        discrete[i] = parameter->isDiscrete() || parameter->isBoolean();
+    }
+
+    clearScript();
+}
+
+MovementSequencer::~MovementSequencer()
+{
+}
+
+int MovementSequencer::setScript(const Script& script)
+{
+    auto next = std::make_unique<Compiled>();
+    next->id = nextScriptId++;
+    next->lengthBeats = juce::jmax(1.0 / 64.0, script.lengthBeats);
+    next->loop = script.loop;
+    next->events.reserve(script.events.size());
+
+    for (const auto& event : script.events)
+    {
+        if (event.beat < 0.0 || event.beat >= next->lengthBeats)
+            continue;
+
+        CompiledEvent compiled;
+        compiled.beat = event.beat;
+        compiled.type = event.type;
+        compiled.target = juce::jlimit(0, numTargets - 1, static_cast<int>(event.target));
+        compiled.note = juce::jlimit(0, 127, event.note);
+        compiled.velocity = juce::jlimit(0.0f, 1.0f, event.velocity);
+
+        if (event.type == EventType::ramp)
+        {
+            compiled.parameter = PresetSchema::indexOf(event.parameter);
+            if (compiled.parameter < 0 || !known[compiled.parameter])
+                continue;
+
+            const auto& range = PresetSchema::parameters[compiled.parameter];
+            compiled.value = juce::jlimit(range.minValue, range.maxValue, event.value);
+
+            // Switches and choices cannot glide
+            compiled.rampBeats = discrete[compiled.parameter] ? 0.0 : juce::jmax(0.0, event.rampBeats);
+            compiled.shape = event.shape;
+        }
+
+        next->events.push_back(compiled);
+    }
+
+    // Note-offs first at equal times, so a retrigger on the same beat is heard
+    std::stable_sort(next->events.begin(), next->events.end(), [](const CompiledEvent& a, const CompiledEvent& b)
+    {
+        if (a.beat != b.beat)
+            return a.beat < b.beat;
+
+        return a.type == EventType::noteOff && b.type != EventType::noteOff;
+    });
+
+    auto numKept = static_cast<int>(next->events.size());
+
+    // Only succeeds while the audio thread is not using the current script
+    auto* expected = ownedScript.get();
+    while (!scriptSlot.compare_exchange_weak(expected, next.get(), std::memory_order_acq_rel))
+    {
+        expected = ownedScript.get();
+        juce::Thread::yield();
+    }
+
+    ownedScript = std::move(next);
+
+    {
+        const juce::ScopedLock sl(scriptLock);
+        currentScript = script;
+    }
+
+    if (onChanged != nullptr)
+        onChanged();
+
+    return numKept;
+}
+
+void MovementSequencer::clearScript()
+{
+    Script empty;
+    empty.loop = false;
+    setScript(empty);
+}
+
+MovementSequencer::Script MovementSequencer::getScript() const
+{
+    const juce::ScopedLock sl(scriptLock);
+    return currentScript;
+}
+
+juce::ValueTree MovementSequencer::createState() const
+{
+    auto script = getScript();
+
+    juce::ValueTree state(stateType, { { nameProperty, script.name },
+                                       { lengthProperty, script.lengthBeats },
+                                       { loopProperty, script.loop } });
+
+    for (const auto& event : script.events)
+        state.appendChild(juce::ValueTree(eventType, { { beatProperty, event.beat },
+                                                       { typeProperty, static_cast<int>(event.type) },
+                                                       { targetProperty, static_cast<int>(event.target) },
+                                                       { noteProperty, event.note },
+                                                       { velocityProperty, event.velocity },
+                                                       { parameterProperty, event.parameter },
+                                                       { valueProperty, event.value },
+                                                       { rampBeatsProperty, event.rampBeats },
+                                                       { shapeProperty, static_cast<int>(event.shape) } }), nullptr);
+
+    return state;
+}
+
+void MovementSequencer::restoreState(const juce::ValueTree& state)
+{
+    if (!state.hasType(stateType))
+    {
+        clearScript();
+        return;
+    }
+
+    Script script;
+    script.name = state[nameProperty].toString();
+    script.lengthBeats = state.getProperty(lengthProperty, script.lengthBeats);
+    script.loop = state.getProperty(loopProperty, script.loop);
+
+    // setScript() drops anything out of range
+    for (const auto& child : state)
+    {
+        if (!child.hasType(eventType))
+            continue;
+
+        Event event;
+        event.beat = child[beatProperty];
+        event.type = static_cast<EventType>(juce::jlimit(0, 2, static_cast<int>(child[typeProperty])));
+        event.target = static_cast<Target>(juce::jlimit(0, numTargets - 1, static_cast<int>(child[targetProperty])));
+        event.note = child[noteProperty];
+        event.velocity = child[velocityProperty];
+        event.parameter = child[parameterProperty].toString();
+        event.value = child[valueProperty];
+        event.rampBeats = child[rampBeatsProperty];
+        event.shape = static_cast<RampShape>(juce::jlimit(0, 1, static_cast<int>(child[shapeProperty])));
+        script.events.push_back(event);
+    }
+
+    setScript(script);
+}
+
+MovementSequencer::Script MovementSequencer::getSpinUpScript()
+{
+    auto note = [](double beat, EventType type, Target target, int noteNumber, float velocity = 1.0f)
+    {
+        Event event;
+        event.beat = beat;
+        event.type = type;
+        event.target = target;
+        event.note = noteNumber;
+        event.velocity = velocity;
+        return event;
+    };
+
+    auto ramp = [](double beat, const char* parameter, float value, double beats, RampShape shape)
+    {
+        Event event;
+        event.beat = beat;
+        event.type = EventType::ramp;
+        event.parameter = parameter;
+        event.value = value;
+        event.rampBeats = beats;
+        event.shape = shape;
+        return event;
+    };
+
+    Script script;
+    script.name = "Spin Up";
+    script.lengthBeats = 4.0;
+    script.loop = true;
+    script.events = {
+        // Servo spins up over the first beat and winds down at the end
+        ramp(0.0,  "SERVO_SPEED", 5.0f, 0.0, RampShape::linear),
+        ramp(0.0,  "SERVO_SPEED", 80.0f, 1.0, RampShape::smooth),
+        ramp(3.5,  "SERVO_SPEED", 20.0f, 0.5, RampShape::smooth),
+
+        // Pressure builds, then the hiss releases it
+        ramp(0.5,  "HYDRAULIC_PRESSURE", 6.0f, 0.5, RampShape::linear),
+        note(1.0,  EventType::noteOn,  hydraulic, 60, 0.8f),
+        note(2.0,  EventType::noteOff, hydraulic, 60),
+
+        // Gears engage
+        note(1.5,  EventType::noteOn,  gear, 66, 0.9f),
+        note(3.0,  EventType::noteOff, gear, 66),
+
+        // And the foot lands
+        note(3.0,  EventType::noteOn,  metal, 72, 1.0f),
+        note(3.25, EventType::noteOff, metal, 72),
+    };
+
+    return script;
+}
+
+//==============================================================================
+void MovementSequencer::prepare(double sampleRate, int samplesPerBlock)
+{
+    juce::ignoreUnused(samplesPerBlock);
+    currentSampleRate = sampleRate;
+
+    // Enough for a dense script and a busy host buffer without reallocating
+    for (auto& midi : targetMidi)
+        midi.ensureSize(2048);
+
+    mergedMidi.ensureSize(8192);
+
+    reset();
+}
+
+void MovementSequencer::reset()
+{
+    for (auto& midi : targetMidi)
+        midi.clear();
+
+    for (auto& held : heldNotes)
+        held.reset();
+
+    for (auto& ramp : ramps)
+        ramp.parameter = -1;
+
+    clearOverrides();
+    lastScriptId = 0;
+    cursor = 0;
+    expectedPpq = 0.0;
+    wasPlaying = false;
+}
+
+void MovementSequencer::process(const Transport& transport, int numSamples, BlockParameters& parameters)
+{
+    for (auto& midi : targetMidi)
+        midi.clear();
+
+    auto* script = scriptSlot.exchange(nullptr, std::memory_order_acquire);
+    if (script == nullptr)
+        return;
+
+    bool newScript = script->id != lastScriptId;
+    lastScriptId = script->id;
+
+    if (!transport.playing || transport.bpm <= 0.0 || script->events.empty())
+    {
+        // The parameters take over again
+        if (wasPlaying || newScript)
+        {
+            releaseHeldNotes();
+            clearOverrides();
+        }
+
+        wasPlaying = false;
+        scriptSlot.store(script, std::memory_order_release);
+        return;
+    }
+
+    // Sample positions follow the host tempo. A tempo change only rescales:
+    // held notes keep sounding and running ramps keep their progress in beats.
+    auto samplesPerBeat = currentSampleRate * 60.0 / transport.bpm;
+    bool rescaled = newScript || samplesPerBeat != script->samplesPerBeat;
+    if (rescaled)
+    {
+        if (!newScript && script->samplesPerBeat > 0.0)
+            rescaleRamps(samplesPerBeat / script->samplesPerBeat);
+
+        rescale(*script, samplesPerBeat);
+    }
+
+    auto position = static_cast<juce::int64>(std::llround(transport.ppqPosition * samplesPerBeat));
+
+    if (script->loop)
+        position = ((position % script->lengthSamples) + script->lengthSamples) % script->lengthSamples;
+
+    // A different script's overrides no longer apply
+    if (newScript)
+        clearOverrides();
+
+    // Anything but a continuation of the last block is a locate; measured in
+    // beats, so tempo automation does not count
+    if (!wasPlaying || newScript || std::abs(transport.ppqPosition - expectedPpq) > locateToleranceBeats)
+    {
+        releaseHeldNotes();
+        seek(*script, position);
+    }
+    else if (rescaled)
+    {
+        seek(*script, position);
+    }
+
+    expectedPpq = transport.ppqPosition + numSamples / samplesPerBeat;
+    wasPlaying = true;
+
+    auto blockStart = position;
+    auto remaining = static_cast<juce::int64>(numSamples);
+    int offset = 0;
+    const auto numEvents = script->events.size();
+
+    while (remaining > 0)
+    {
+        auto blockEnd = blockStart + remaining;
+        auto segmentEnd = script->loop ? juce::jmin(blockEnd, script->lengthSamples) : blockEnd;
+
+        while (cursor < numEvents && script->events[cursor].sample < segmentEnd)
+        {
+            const auto& event = script->events[cursor++];
+            dispatch(event, offset + static_cast<int>(event.sample - blockStart), numSamples, parameters);
+        }
+
+        if (!script->loop || blockEnd < script->lengthSamples)
+            break;
+
+        // Wrap to the top of the loop inside this block
+        auto consumed = script->lengthSamples - blockStart;
+        offset += static_cast<int>(consumed);
+        remaining -= consumed;
+        blockStart = 0;
+        cursor = 0;
+    }
+
+    advanceRamps(numSamples);
+    applyOverrides(parameters);
+
+    scriptSlot.store(script, std::memory_order_release);
+}
+
+juce::MidiBuffer& MovementSequencer::getMidiFor(int target, juce::MidiBuffer& hostMidi)
+{
+    if (!juce::isPositiveAndBelow(target, numTargets))
+        return hostMidi;
+
+    const auto& scriptMidi = targetMidi[static_cast<size_t>(target)];
+    if (scriptMidi.isEmpty())
+        return hostMidi;
+
+    mergedMidi.clear();
+    mergedMidi.addEvents(hostMidi, 0, -1, 0);
+    mergedMidi.addEvents(scriptMidi, 0, -1, 0);
+    return mergedMidi;
+}
+
+void MovementSequencer::addMidi(int target, const juce::MidiMessage& message, int sampleOffset)
+{
+    if (juce::isPositiveAndBelow(target, numTargets))
+        targetMidi[static_cast<size_t>(target)].addEvent(message, sampleOffset);
+}
+
+void MovementSequencer::rescale(Compiled& script, double samplesPerBeat)
+{
+    script.samplesPerBeat = samplesPerBeat;
+    script.lengthSamples = juce::jmax(static_cast<juce::int64>(1),
+        static_cast<juce::int64>(std::llround(script.lengthBeats * samplesPerBeat)));
+
+    for (auto& event : script.events)
+    {
+        event.sample = juce::jmin(script.lengthSamples - 1, static_cast<juce::int64>(std::llround(event.beat * samplesPerBeat)));
+        event.rampSamples = static_cast<juce::int64>(std::llround(event.rampBeats * samplesPerBeat));
+    }
+}
+
+void MovementSequencer::rescaleRamps(double ratio)
+{
+    for (auto& ramp : ramps)
+    {
+        if (ramp.parameter < 0)
+            continue;
+
+        ramp.position = static_cast<juce::int64>(std::llround(static_cast<double>(ramp.position) * ratio));
+        ramp.length = static_cast<juce::int64>(std::llround(static_cast<double>(ramp.length) * ratio));
+    }
+}
+
+void MovementSequencer::seek(const Compiled& script, juce::int64 position)
+{
+    auto found = std::lower_bound(script.events.begin(), script.events.end(), position,
+        [](const CompiledEvent& event, juce::int64 samplePosition) { return event.sample < samplePosition; });
+
+    cursor = static_cast<size_t>(std::distance(script.events.begin(), found));
+}
+
+void MovementSequencer::dispatch(const CompiledEvent& event, int offset, int numSamples, const BlockParameters& parameters)
+{
+    offset = juce::jlimit(0, numSamples - 1, offset);
+    auto& midi = targetMidi[static_cast<size_t>(event.target)];
+    auto& held = heldNotes[static_cast<size_t>(event.target)];
+
+    switch (event.type)
+    {
+    case EventType::noteOn:
+        midi.addEvent(juce::MidiMessage::noteOn(1, event.note, event.velocity), offset);
+        held.set(static_cast<size_t>(event.note));
+        break;
+
+    case EventType::noteOff:
+        midi.addEvent(juce::MidiMessage::noteOff(1, event.note), offset);
+        held.reset(static_cast<size_t>(event.note));
+        break;
+
+    case EventType::ramp:
+    {
+        // A new ramp on a parameter replaces the one already running
+        Ramp* slot = nullptr;
+
+        for (auto& ramp : ramps)
+        {
+            if (ramp.parameter == event.parameter)
+            {
+                slot = &ramp;
+                break;
+            }
+
+            if (slot == nullptr && ramp.parameter < 0)
+                slot = &ramp;
+        }
+
+        // A jump is set straight away so a ramp on the same beat starts from it
+        if (event.rampSamples <= 0)
+        {
+            overrideValues[static_cast<size_t>(event.parameter)] = event.value;
+            overridden.set(static_cast<size_t>(event.parameter));
+
+            if (slot != nullptr && slot->parameter == event.parameter)
+                slot->parameter = -1;
+
+            break;
+        }
+
+        if (slot == nullptr)
+            break;
+
+        slot->parameter = event.parameter;
+        // From the value the generators are hearing
+        auto index = static_cast<size_t>(event.parameter);
+        slot->startValue = overridden.test(index) ? overrideValues[index] : parameters.get(event.parameter);
+        slot->endValue = event.value;
+        slot->length = event.rampSamples;
+        slot->shape = event.shape;
+
+        // Counted from the event, not the block start
+        slot->position = -static_cast<juce::int64>(offset);
+        break;
+    }
+    }
+}
+
+void MovementSequencer::advanceRamps(int numSamples)
+{
+    for (auto& ramp : ramps)
+    {
+        if (ramp.parameter < 0)
+            continue;
+
+        ramp.position += numSamples;
+
+        auto t = ramp.length > 0 ? juce::jlimit(0.0f, 1.0f, static_cast<float>(ramp.position) / static_cast<float>(ramp.length))
+                                 : 1.0f;
+
+        if (ramp.shape == RampShape::smooth)
+            t = t * t * (3.0f - 2.0f * t);
+
+        overrideValues[static_cast<size_t>(ramp.parameter)] = ramp.startValue + (ramp.endValue - ramp.startValue) * t;
+        overridden.set(static_cast<size_t>(ramp.parameter));
+
+        if (ramp.position >= ramp.length)
+            ramp.parameter = -1;
+    }
+}
+
+void MovementSequencer::applyOverrides(BlockParameters& parameters) const
+{
+    if (overridden.none())
+        return;
+
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        if (overridden.test(static_cast<size_t>(i)))
+            parameters.set(i, overrideValues[static_cast<size_t>(i)]);
+}
+
+void MovementSequencer::clearOverrides()
+{
+    overridden.reset();
+}
+
+void MovementSequencer::releaseHeldNotes()
+{
+    for (int target = 0; target < numTargets; ++target)
+    {
+        auto& held = heldNotes[static_cast<size_t>(target)];
+        if (held.none())
+            continue;
+
+        for (int note = 0; note < 128; ++note)
+            if (held.test(static_cast<size_t>(note)))
+                targetMidi[static_cast<size_t>(target)].addEvent(juce::MidiMessage::noteOff(1, note), 0);
+
+        held.reset();
+    }
+
+    // Ramps stop where they are
+    for (auto& ramp : ramps)
+        ramp.parameter = -1;
+}
@@ -0,0 +1,207 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <bitset>
+#include "BlockParameters.h"
+
+// Plays movement scripts - timed note events for the five generators plus
+// parameter ramps - locked to the host transport.
+//
+// A script is written in beats. setScript() compiles it on the message thread
+// into one flat array sorted by time, and the audio thread walks it with a
+// cursor: each block dispatches the events that fall inside it at their exact
+// sample offset, so playback costs one comparison and one increment per event.
+// Sample positions are derived from the beats and are rescaled in place when
+// the tempo or sample rate changes, without interrupting notes or ramps. A jump
+// in the host position (locate, loop), detected in beats, moves the cursor with
+// a binary search.
+//
+// Notes go to one generator only: each target gets its own MIDI buffer, merged
+// with the host MIDI when that generator renders. Ramps and jumps override the
+// block's BlockParameters and never the parameters themselves, so the host and
+// saved state keep the user's values; the overrides hold until the transport
+// stops or the script changes. Nothing plays while the transport is stopped,
+// and held notes are released when it stops or jumps. The script is part of
+// the session state.
+class MovementSequencer
+{
+public:
+    // In the processor's mixing order
+    enum Target
+    {
+        hydraulic,
+        servo,
+        metal,
+        gear,
+        sample,
+        numTargets
+    };
+
+    enum class EventType
+    {
+        noteOn,
+        noteOff,
+        ramp
+    };
+
+    enum class RampShape
+    {
+        linear,
+        smooth
+    };
+
+    struct Event
+    {
+        double beat = 0.0;
+        EventType type = EventType::noteOn;
+
+        // Note events
+        Target target = hydraulic;
+        int note = 60;
+        float velocity = 1.0f;
+
+        // Ramp events: glide from the current value to value over rampBeats
+        juce::String parameter;
+        float value = 0.0f;
+        double rampBeats = 0.0;
+        RampShape shape = RampShape::linear;
+    };
+
+    struct Script
+    {
+        juce::String name;
+        double lengthBeats = 4.0;
+        bool loop = true;
+        std::vector<Event> events;
+    };
+
+    struct Transport
+    {
+        bool playing = false;
+        double ppqPosition = 0.0;
+        double bpm = 120.0;
+    };
+
+    static constexpr int maxRamps = 32;
+
+    explicit MovementSequencer(juce::AudioProcessorValueTreeState& vts);
+    ~MovementSequencer();
+
+    // Message thread. Compiles and publishes the script, replacing the current
+    // one. Events outside the script or naming unknown parameters are dropped;
+    // returns how many were kept.
+    int setScript(const Script& script);
+    void clearScript();
+
+    // Any thread; the script as last given to setScript()
+    Script getScript() const;
+
+    // The script, for the session state. Restoring an invalid tree clears it.
+    juce::ValueTree createState() const;
+    void restoreState(const juce::ValueTree& state);
+
+    static const juce::Identifier stateType;
+
+    // Called on the message thread after the script changes
+    std::function<void()> onChanged;
+
+    // Servo spin-up, hydraulic hiss, gear engage and a metal impact in one bar
+    static Script getSpinUpScript();
+
+    // Audio thread
+    void prepare(double sampleRate, int samplesPerBlock);
+    void reset();
+    // Applies this block's ramps and jumps to parameters
+    void process(const Transport& transport, int numSamples, BlockParameters& parameters);
+
+    // The MIDI one generator should see this block: the host's, plus the
+    // script's notes for that generator when there are any
+    juce::MidiBuffer& getMidiFor(int target, juce::MidiBuffer& hostMidi);
+
+    // Audio thread, after process(): more MIDI for one generator this block,
+    // such as editor triggers
+    void addMidi(int target, const juce::MidiMessage& message, int sampleOffset);
+
+private:
+    struct CompiledEvent
+    {
+        double beat = 0.0;
+        juce::int64 sample = 0;
+        EventType type = EventType::noteOn;
+        int target = 0;
+        int note = 0;
+        float velocity = 0.0f;
+        int parameter = -1;
+        float value = 0.0f;
+        double rampBeats = 0.0;
+        juce::int64 rampSamples = 0;
+        RampShape shape = RampShape::linear;
+    };
+
+    struct Compiled
+    {
+        juce::uint32 id = 0;
+        std::vector<CompiledEvent> events;
+        double lengthBeats = 4.0;
+        bool loop = true;
+
+        // Audio thread: the tempo and rate the sample positions were made for
+        double samplesPerBeat = 0.0;
+        juce::int64 lengthSamples = 0;
+    };
+
+    struct Ramp
+    {
+        int parameter = -1;
+        float startValue = 0.0f;
+        float endValue = 0.0f;
+        juce::int64 position = 0;
+        juce::int64 length = 0;
+        RampShape shape = RampShape::linear;
+    };
+
+    void rescale(Compiled& script, double samplesPerBeat);
+    void rescaleRamps(double ratio);
+    void seek(const Compiled& script, juce::int64 position);
+    void dispatch(const CompiledEvent& event, int offset, int numSamples, const BlockParameters& parameters);
+    void advanceRamps(int numSamples);
+    void applyOverrides(BlockParameters& parameters) const;
+    void releaseHeldNotes();
+    void clearOverrides();
+
+    // Resolved once; indexed in schema order
+    std::array<bool, PresetSchema::numParameters> known{};
+    std::array<bool, PresetSchema::numParameters> discrete{};
+
+    // Message thread
+    std::unique_ptr<Compiled> ownedScript;
+    juce::uint32 nextScriptId = 1;
+
+    Script currentScript;
+    juce::CriticalSection scriptLock;
+
+    // Holds ownedScript except while the audio thread is using it
+    std::atomic<Compiled*> scriptSlot{ nullptr };
+
+    // Audio thread state
+    double currentSampleRate = 44100.0;
+    juce::uint32 lastScriptId = 0;
+    size_t cursor = 0;
+    double expectedPpq = 0.0;
+
+    // Host positions further than this from where the last block ended are a locate
+    static constexpr double locateToleranceBeats = 1.0 / 64.0;
+    bool wasPlaying = false;
+
+    std::array<Ramp, maxRamps> ramps;
+
+    // The values ramps and jumps have set, laid over the parameters each block
+    PresetSchema::Values overrideValues{};
+    std::bitset<PresetSchema::numParameters> overridden;
+    std::array<std::bitset<128>, numTargets> heldNotes;
+
+    std::array<juce::MidiBuffer, numTargets> targetMidi;
+    juce::MidiBuffer mergedMidi;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(MovementSequencer)
+};
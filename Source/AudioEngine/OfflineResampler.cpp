@@ -0,0 +1,95 @@
+#include "OfflineResampler.h"
+
+OfflineResampler::OfflineResampler()
+{
+    // Precompute one side of the symmetric kernel; one extra point for interpolation
+    auto numPoints = zeroCrossings * tableResolution + 2;
+    kernelTable.resize(static_cast<size_t>(numPoints));
+
+    auto windowNorm = besselI0(kaiserBeta);
+
+    for (int i = 0; i < numPoints; ++i)
+    {
+        auto x = static_cast<double>(i) / tableResolution;
+        auto ratio = juce::jmin(1.0, x / zeroCrossings);
+
+        auto sinc = (x == 0.0) ? 1.0 : std::sin(juce::MathConstants<double>::pi * x) / (juce::MathConstants<double>::pi * x);
+        auto window = besselI0(kaiserBeta * std::sqrt(1.0 - ratio * ratio)) / windowNorm;
+
+        kernelTable[static_cast<size_t>(i)] = static_cast<float>(sinc * window);
+    }
+}
+
+juce::AudioBuffer<float> OfflineResampler::process(const juce::AudioBuffer<float>& source,
+    double sourceRate, double targetRate) const
+{
+    jassert(sourceRate > 0.0 && targetRate > 0.0);
+
+    auto numInputFrames = source.getNumSamples();
+    auto ratio = targetRate / sourceRate;
+    auto numOutputFrames = static_cast<int>(std::ceil(numInputFrames * ratio));
+
+    juce::AudioBuffer<float> output(source.getNumChannels(), numOutputFrames);
+
+    // When downsampling the kernel is stretched so it also acts as the anti-alias filter
+    auto cutoff = juce::jmin(1.0, ratio) * passband;
+    auto halfWidth = static_cast<int>(std::ceil(zeroCrossings / cutoff));
+
+    for (int channel = 0; channel < source.getNumChannels(); ++channel)
+    {
+        auto* in = source.getReadPointer(channel);
+        auto* out = output.getWritePointer(channel);
+
+        for (int n = 0; n < numOutputFrames; ++n)
+        {
+            auto position = n / ratio;
+            auto centre = static_cast<int>(std::floor(position));
+
+            auto first = juce::jmax(0, centre - halfWidth + 1);
+            auto last = juce::jmin(numInputFrames - 1, centre + halfWidth);
+
+            double sum = 0.0;
+
+            for (int k = first; k <= last; ++k)
+                sum += in[k] * kernelAt(std::abs(position - k) * cutoff);
+
+            out[n] = static_cast<float>(sum * cutoff);
+        }
+    }
+
+    return output;
+}
+
+float OfflineResampler::kernelAt(double distance) const noexcept
+{
+    auto index = distance * tableResolution;
+    auto i = static_cast<int>(index);
+
+    if (i >= zeroCrossings * tableResolution)
+        return 0.0f;
+
+    auto fraction = static_cast<float>(index - i);
+    auto a = kernelTable[static_cast<size_t>(i)];
+    auto b = kernelTable[static_cast<size_t>(i + 1)];
+
+    return a + fraction * (b - a);
+}
+
+double OfflineResampler::besselI0(double x)
+{
+    // Power series; converges quickly for the beta values used here
+    double sum = 1.0;
+    double term = 1.0;
+    auto halfX = x * 0.5;
+
+    for (int k = 1; k < 50; ++k)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+
+        if (term < sum * 1.0e-12)
+            break;
+    }
+
+    return sum;
+}
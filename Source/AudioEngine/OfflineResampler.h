@@ -0,0 +1,30 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// High-quality, non-real-time sample rate converter used when samples are loaded.
+// Kaiser-windowed sinc with the cutoff lowered when downsampling, so the result is
+// band-limited for the target rate. Far too expensive for the audio thread.
+class OfflineResampler
+{
+public:
+    OfflineResampler();
+
+    juce::AudioBuffer<float> process(const juce::AudioBuffer<float>& source,
+        double sourceRate, double targetRate) const;
+
+private:
+    static constexpr int zeroCrossings = 32;
+    static constexpr int tableResolution = 512; // kernel points per input sample
+    static constexpr double kaiserBeta = 8.6;
+    static constexpr double passband = 0.97;    // fraction of the lower Nyquist kept
+
+    // Windowed sinc lobe for distance 0..zeroCrossings at unit cutoff
+    std::vector<float> kernelTable;
+
+    float kernelAt(double distance) const noexcept;
+
+    static double besselI0(double x);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineResampler)
+};
@@ -0,0 +1,146 @@
+#include "SampleData.h"
+
+SampleData::SampleData(juce::AudioBuffer<float>&& decodedAudio, double fileSampleRate, StorageFormat format,
+    const juce::String& hashOfSource)
+    : numFrames(decodedAudio.getNumSamples()),
+    numChannels(decodedAudio.getNumChannels()),
+    sourceSampleRate(fileSampleRate),
+    storageFormat(format),
+    contentHash(hashOfSource)
+{
+    if (storageFormat == StorageFormat::float32)
+    {
+        buffer = std::move(decodedAudio);
+        return;
+    }
+
+    pcm16.malloc(static_cast<size_t>(numChannels) * static_cast<size_t>(numFrames));
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        auto* src = decodedAudio.getReadPointer(channel);
+        auto* dest = pcm16.get() + static_cast<size_t>(channel) * static_cast<size_t>(numFrames);
+
+        for (int i = 0; i < numFrames; ++i)
+            dest[i] = static_cast<int16_t>(juce::roundToInt(juce::jlimit(-1.0f, 1.0f, src[i]) * 32767.0f));
+    }
+}
+
+SampleData::Ptr SampleData::decode(juce::AudioFormatReader& reader, StorageFormat format,
+    const juce::String& hashOfSource)
+{
+    auto frames = static_cast<int>(reader.lengthInSamples);
+    auto channels = static_cast<int>(reader.numChannels);
+
+    juce::AudioBuffer<float> decoded(channels, frames);
+    if (!reader.read(&decoded, 0, frames, 0, true, true))
+        return nullptr;
+
+    return new SampleData(std::move(decoded), reader.sampleRate, format, hashOfSource);
+}
+
+juce::AudioBuffer<float> SampleData::toFloatBuffer() const
+{
+    if (storageFormat == StorageFormat::float32)
+        return buffer;
+
+    juce::AudioBuffer<float> audio(numChannels, numFrames);
+    constexpr float scale = 1.0f / 32767.0f;
+
+    for (int channel = 0; channel < numChannels; ++channel)
+    {
+        const auto* src = pcm16.get() + static_cast<size_t>(channel) * static_cast<size_t>(numFrames);
+        auto* dest = audio.getWritePointer(channel);
+
+        for (int i = 0; i < numFrames; ++i)
+            dest[i] = static_cast<float>(src[i]) * scale;
+    }
+
+    return audio;
+}
+
+size_t SampleData::getMemoryFootprintBytes() const
+{
+    auto numValues = static_cast<size_t>(numChannels) * static_cast<size_t>(numFrames);
+    return storageFormat == StorageFormat::int16 ? numValues * sizeof(int16_t)
+                                                 : numValues * sizeof(float);
+}
+
+void SampleData::decodeBlock(int channel, int blockIndex, float* dest) const noexcept
+{
+    jassert(channel >= 0 && channel < numChannels);
+
+    auto start = blockIndex * blockSize;
+    auto count = juce::jlimit(0, blockSize + 1, numFrames - start);
+
+    if (count <= 0)
+    {
+        count = 0;
+    }
+    else if (storageFormat == StorageFormat::float32)
+    {
+        juce::FloatVectorOperations::copy(dest, buffer.getReadPointer(channel, start), count);
+    }
+    else
+    {
+        const auto* src = pcm16.get() + static_cast<size_t>(channel) * static_cast<size_t>(numFrames) + start;
+        constexpr float scale = 1.0f / 32767.0f;
+
+        // Plain widening loop with no dependencies between iterations so the
+        // compiler emits packed int16 -> float conversions for it
+        for (int i = 0; i < count; ++i)
+            dest[i] = static_cast<float>(src[i]) * scale;
+    }
+
+    if (count < blockSize + 1)
+        juce::FloatVectorOperations::clear(dest + count, blockSize + 1 - count);
+}
+
+SampleReleasePool::SampleReleasePool()
+    : juce::Thread("Sample Release Pool")
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+SampleReleasePool::~SampleReleasePool()
+{
+    stopThread(2 * collectionIntervalMs);
+}
+
+void SampleReleasePool::add(const SampleData::Ptr& sample)
+{
+    if (sample == nullptr)
+        return;
+
+    const juce::ScopedLock sl(lock);
+    pool.push_back(sample);
+}
+
+void SampleReleasePool::run()
+{
+    while (!threadShouldExit())
+    {
+        releaseUnused();
+        wait(collectionIntervalMs);
+    }
+}
+
+void SampleReleasePool::releaseUnused()
+{
+    std::vector<SampleData::Ptr> unused;
+
+    {
+        const juce::ScopedLock sl(lock);
+
+        // A reference count of one means only the pool still points at the sample:
+        // it is no longer published and no voice is playing it
+        auto firstUnused = std::stable_partition(pool.begin(), pool.end(),
+            [](const SampleData::Ptr& sample) { return sample->getReferenceCount() > 1; });
+
+        std::move(firstUnused, pool.end(), std::back_inserter(unused));
+        pool.erase(firstUnused, pool.end());
+    }
+
+    // Buffers are freed here, outside the lock
+    unused.clear();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Immutable, decoded sample shared between the loader threads and the audio thread.
+// Once constructed the audio data is never modified, so any number of voices can
+// read it without locking.
+class SampleData : public juce::ReferenceCountedObject
+{
+public:
+    using Ptr = juce::ReferenceCountedObjectPtr<SampleData>;
+
+    // How the audio is held in memory. Int16 halves the footprint of large
+    // libraries; it is read through fixed-size blocks decoded on demand.
+    enum class StorageFormat
+    {
+        float32,
+        int16
+    };
+
+    static constexpr int blockSize = 256;
+
+    SampleData() = default;
+    SampleData(juce::AudioBuffer<float>&& decodedAudio, double fileSampleRate,
+        StorageFormat format = StorageFormat::float32, const juce::String& hashOfSource = {});
+
+    // Decodes the whole reader into a new sample (call from a non-real-time thread)
+    static Ptr decode(juce::AudioFormatReader& reader, StorageFormat format = StorageFormat::float32,
+        const juce::String& hashOfSource = {});
+
+    // Full-precision copy of the audio regardless of storage format
+    juce::AudioBuffer<float> toFloatBuffer() const;
+
+    // Float32 storage only; empty for compressed samples
+    const juce::AudioBuffer<float>& getBuffer() const { return buffer; }
+
+    int getNumFrames() const { return numFrames; }
+    int getNumChannels() const { return numChannels; }
+    double getSourceSampleRate() const { return sourceSampleRate; }
+    bool isEmpty() const { return numFrames == 0; }
+
+    // Hash of the encoded file this sample came from; empty if unknown
+    const juce::String& getContentHash() const { return contentHash; }
+
+    StorageFormat getStorageFormat() const { return storageFormat; }
+    bool isCompressed() const { return storageFormat != StorageFormat::float32; }
+    int getNumBlocks() const { return (numFrames + blockSize - 1) / blockSize; }
+    size_t getMemoryFootprintBytes() const;
+
+    // Writes blockSize + 1 frames starting at blockIndex * blockSize into dest, so
+    // interpolation never has to look past the block. Frames past the end are zero.
+    void decodeBlock(int channel, int blockIndex, float* dest) const noexcept;
+
+private:
+    juce::AudioBuffer<float> buffer;
+    juce::HeapBlock<int16_t> pcm16;  // planar, numFrames per channel
+
+    int numFrames = 0;
+    int numChannels = 0;
+    double sourceSampleRate = 44100.0;
+    StorageFormat storageFormat = StorageFormat::float32;
+    juce::String contentHash;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleData)
+};
+
+// Holds a reference to every published sample and frees the ones nobody else uses
+// on a background thread, so the audio thread never deallocates sample memory.
+// Shared between plugin instances through juce::SharedResourcePointer.
+class SampleReleasePool : private juce::Thread
+{
+public:
+    SampleReleasePool();
+    ~SampleReleasePool() override;
+
+    void add(const SampleData::Ptr& sample);
+
+private:
+    void run() override;
+    void releaseUnused();
+
+    juce::CriticalSection lock;
+    std::vector<SampleData::Ptr> pool;
+
+    static constexpr int collectionIntervalMs = 500;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleReleasePool)
+};
+
+// Worker threads used to decode sample files away from the message and audio threads.
+// Shared between plugin instances through juce::SharedResourcePointer.
+class SampleLoaderPool : public juce::ThreadPool
+{
+public:
+    SampleLoaderPool() : juce::ThreadPool(2) {}
+};
@@ -1,5 +1,26 @@
 #include "SamplePlayback.h"
 
+// Background work for one SamplePlayback on the shared loader pool
+class SamplePlayback::SampleJob : public juce::ThreadPoolJob
+{
+public:
+    SampleJob(SamplePlayback& o, const juce::String& name, std::function<void()> jobWork)
+        : juce::ThreadPoolJob(name), owner(o), work(std::move(jobWork))
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        work();
+        return jobHasFinished;
+    }
+
+    SamplePlayback& owner;
+
+private:
+    std::function<void()> work;
+};
+
 SamplePlayback::SamplePlayback()
 {
     // Initialize envelope parameters
@@ -13,10 +34,32 @@ SamplePlayback::SamplePlayback()
     {
         voice.envelope.setParameters(envelopeParams);
     }
+
+    // Start with an empty sample so the slot is never null outside a block
+    publishedSample = new SampleData();
+    sourceSample = publishedSample;
+    releasePool->add(publishedSample);
+    sampleSlot.store(publishedSample.get(), std::memory_order_release);
 }
 
 SamplePlayback::~SamplePlayback()
 {
+    // Cancel any decode still queued for this instance on the shared pool
+    struct OwnJobs : public juce::ThreadPool::JobSelector
+    {
+        explicit OwnJobs(SamplePlayback& o) : owner(o) {}
+
+        bool isJobSuitable(juce::ThreadPoolJob* job) override
+        {
+            auto* loadJob = dynamic_cast<SampleJob*>(job);
+            return loadJob != nullptr && &loadJob->owner == &owner;
+        }
+
+        SamplePlayback& owner;
+    };
+
+    OwnJobs ownJobs(*this);
+    loaderPool->removeAllJobs(true, 5000, &ownJobs);
 }
 
 void SamplePlayback::prepare(double sampleRate, int samplesPerBlock)
@@ -24,6 +67,16 @@ void SamplePlayback::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    enableIndex = BlockParameters::indexOf("SAMPLE_ENABLE");
+    gainIndex = BlockParameters::indexOf("SAMPLE_GAIN");
+    pitchIndex = BlockParameters::indexOf("SAMPLE_PITCH");
+    modeIndex = BlockParameters::indexOf("SAMPLE_MODE");
+    grainDensityIndex = BlockParameters::indexOf("SAMPLE_GRAIN_DENSITY");
+    grainSizeIndex = BlockParameters::indexOf("SAMPLE_GRAIN_SIZE");
+    grainPositionIndex = BlockParameters::indexOf("SAMPLE_GRAIN_POSITION");
+    grainJitterIndex = BlockParameters::indexOf("SAMPLE_GRAIN_JITTER");
+    grainSprayIndex = BlockParameters::indexOf("SAMPLE_GRAIN_SPRAY");
+
     // Prepare all voice envelopes
     for (auto& voice : voices)
     {
@@ -33,11 +86,20 @@ void SamplePlayback::prepare(double sampleRate, int samplesPerBlock)
     // Initialize smoothers
     gainSmoother.reset(sampleRate, 0.02); // 20ms smoothing
     pitchSmoother.reset(sampleRate, 0.05); // 50ms smoothing
+
+    // Grain pool and scratch buffers are allocated here, never on the audio thread
+    granular.prepare(sampleRate, samplesPerBlock);
+
+    // Convert the loaded sample to the new session rate in the background;
+    // until it is ready the previous version keeps playing
+    if (sessionSampleRate.exchange(sampleRate) != sampleRate)
+        scheduleRateConversion();
 }
 
 void SamplePlayback::reset()
 {
     stopAllVoices();
+    granular.reset();
 
     // Reset all voice envelopes
     for (auto& voice : voices)
@@ -47,30 +109,43 @@ void SamplePlayback::reset()
 }
 
 void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-    juce::AudioProcessorValueTreeState& apvts)
+    const BlockParameters& parameters)
 {
+    // Hold the published sample for this block; loaders wait until we give it back
+    ScopedSampleAccess access(sampleSlot);
+
     // Get parameters
-    bool enabled = *apvts.getRawParameterValue("SAMPLE_ENABLE");
-    if (!enabled || !hasSample()) return;
+    bool enabled = parameters.get(enableIndex) >= 0.5f;
+    if (!enabled) return;
 
-    float gain = *apvts.getRawParameterValue("SAMPLE_GAIN");
-    float pitch = *apvts.getRawParameterValue("SAMPLE_PITCH");
+    float gain = parameters.get(gainIndex);
+    float pitch = parameters.get(pitchIndex);
 
     // Update smoothed parameters
     gainSmoother.setTargetValue(gain);
     pitchSmoother.setTargetValue(pitch);
 
+    // Switching modes lets whatever was playing in the other mode ring out
+    granularMode = parameters.get(modeIndex) >= 0.5f;
+
     // Process MIDI
     for (const auto metadata : midiMessages)
     {
         auto message = metadata.getMessage();
         if (message.isNoteOn())
         {
-            processMidiNote(message.getNoteNumber(), true, message.getFloatVelocity());
+            if (granularMode)
+                processGranularNote(message.getNoteNumber(), true, message.getFloatVelocity());
+            else
+                processMidiNote(access.sample, message.getNoteNumber(), true, message.getFloatVelocity());
         }
         else if (message.isNoteOff())
         {
-            processMidiNote(message.getNoteNumber(), false, 0.0f);
+            // Both engines hear it, so a note held across a mode switch is still
+            // released by the engine that started it; each ignores notes it is
+            // not playing
+            processGranularNote(message.getNoteNumber(), false, 0.0f);
+            processMidiNote(access.sample, message.getNoteNumber(), false, 0.0f);
         }
         else if (message.isController())
         {
@@ -78,6 +153,20 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
         }
     }
 
+    // Granular texture from the current sample
+    if (granular.isActive() && access.sample != nullptr)
+    {
+        GranularEngine::Settings settings;
+        settings.density = parameters.get(grainDensityIndex);
+        settings.sizeMs = parameters.get(grainSizeIndex);
+        settings.position = parameters.get(grainPositionIndex);
+        settings.positionJitter = parameters.get(grainJitterIndex);
+        settings.pitchSpray = parameters.get(grainSprayIndex);
+        settings.pitch = pitchSmoother.getCurrentValue();
+
+        granular.render(buffer, *access.sample, settings, gainSmoother.getCurrentValue());
+    }
+
     // Generate audio from active voices
     auto numSamples = buffer.getNumSamples();
     auto numOutputChannels = buffer.getNumChannels();
@@ -93,6 +182,8 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
         {
             if (!voice.isActive) continue;
 
+            const auto& voiceSample = *voice.sample;
+
             // Calculate playback position with pitch adjustment
             float playbackSpeed = voice.pitch * currentPitch;
             float currentPos = static_cast<float>(voice.currentPosition);
@@ -104,6 +195,7 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
             if (voice.isReleasing && envelopeValue <= 0.001f)
             {
                 voice.isActive = false;
+                voice.sample = nullptr; // the release pool still holds a reference
                 continue;
             }
 
@@ -111,7 +203,8 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
             for (int channel = 0; channel < numOutputChannels; ++channel)
             {
                 // Get sample value with interpolation
-                float sampleValue = getSampleValue(channel % numChannels, currentPos);
+                float sampleValue = getSampleValue(voiceSample, voice.cache,
+                    channel % voiceSample.getNumChannels(), currentPos);
 
                 // Apply voice parameters
                 sampleValue *= voice.gain * voice.velocity * currentGain * envelopeValue;
@@ -124,7 +217,7 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
             voice.currentPosition += static_cast<int>(playbackSpeed);
 
             // Check if sample has finished playing
-            if (voice.currentPosition >= sampleLength)
+            if (voice.currentPosition >= voiceSample.getNumFrames())
             {
                 if (!voice.isReleasing)
                 {
@@ -136,17 +229,20 @@ void SamplePlayback::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBu
     }
 }
 
-void SamplePlayback::processMidiNote(int midiNote, bool isNoteOn, float velocity)
+void SamplePlayback::processMidiNote(SampleData* sample, int midiNote, bool isNoteOn, float velocity)
 {
     if (isNoteOn)
     {
+        if (sample == nullptr || sample->isEmpty())
+            return;
+
         // Find available voice
         int voiceIndex = findAvailableVoice();
         if (voiceIndex != -1)
         {
             // Calculate pitch based on MIDI note (C4 = 60 as root note)
             float notePitch = std::pow(2.0f, (midiNote - 60) / 12.0f);
-            startVoice(voiceIndex, midiNote, velocity, notePitch);
+            startVoice(voiceIndex, sample, midiNote, velocity, notePitch);
         }
     }
     else
@@ -163,6 +259,21 @@ void SamplePlayback::processMidiNote(int midiNote, bool isNoteOn, float velocity
     }
 }
 
+void SamplePlayback::processGranularNote(int midiNote, bool isNoteOn, float velocity)
+{
+    if (isNoteOn)
+    {
+        // Same root note as voice mode (C4 = 60)
+        granular.noteOn(std::pow(2.0f, (midiNote - 60) / 12.0f), velocity);
+        granularNote = midiNote;
+    }
+    else if (midiNote == granularNote)
+    {
+        granular.noteOff();
+        granularNote = -1;
+    }
+}
+
 void SamplePlayback::processMidiCC(int ccNumber, float ccValue)
 {
     // CC5 controls sample pitch
@@ -180,55 +291,139 @@ void SamplePlayback::processMidiCC(int ccNumber, float ccValue)
 
 bool SamplePlayback::loadSample(const juce::File& file)
 {
-    if (!file.exists())
+    if (!file.existsAsFile())
+        return false;
+
+    // The raw file contents identify the sample in the converted-sample cache
+    juce::MemoryBlock fileData;
+    if (!file.loadFileAsData(fileData))
         return false;
 
+    return loadSample(fileData.getData(), fileData.getSize());
+}
+
+bool SamplePlayback::loadSample(const void* data, size_t dataSize)
+{
     juce::AudioFormatManager formatManager;
     formatManager.registerBasicFormats();
 
-    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(file));
+    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(
+        std::make_unique<juce::MemoryInputStream>(data, dataSize, false)));
 
     if (reader == nullptr)
         return false;
 
-    // Read the sample into our buffer
-    sampleLength = static_cast<int>(reader->lengthInSamples);
-    numChannels = static_cast<int>(reader->numChannels);
+    // Decode into a fresh sample; the one currently playing is left untouched
+    auto contentHash = juce::MD5(data, dataSize).toHexString();
+    auto decoded = SampleData::decode(*reader, storageFormat.load(), contentHash);
+    if (decoded == nullptr)
+        return false;
 
-    sampleBuffer.setSize(numChannels, sampleLength);
-    reader->read(&sampleBuffer, 0, sampleLength, 0, true, true);
+    {
+        const juce::ScopedLock sl(publishLock);
+        sourceSample = decoded;
+    }
 
+    publishForSessionRate(decoded);
     return true;
 }
 
-bool SamplePlayback::loadSample(const void* data, size_t dataSize)
+void SamplePlayback::loadSampleAsync(const juce::File& file, std::function<void(bool)> onLoaded)
 {
-    juce::MemoryInputStream inputStream(data, dataSize, false);
+    loaderPool->addJob(new SampleJob(*this, "Sample Load: " + file.getFileName(),
+        [this, file, onLoaded]
+        {
+            bool loaded = loadSample(file);
 
-    juce::AudioFormatManager formatManager;
-    formatManager.registerBasicFormats();
+            if (onLoaded != nullptr)
+                juce::MessageManager::callAsync([onLoaded, loaded] { onLoaded(loaded); });
+        }), true);
+}
 
-    std::unique_ptr<juce::AudioFormatReader> reader(formatManager.createReaderFor(inputStream));
+void SamplePlayback::clearSample()
+{
+    SampleData::Ptr empty = new SampleData();
 
-    if (reader == nullptr)
-        return false;
+    {
+        const juce::ScopedLock sl(publishLock);
+        sourceSample = empty;
+    }
 
-    // Read the sample into our buffer
-    sampleLength = static_cast<int>(reader->lengthInSamples);
-    numChannels = static_cast<int>(reader->numChannels);
+    // Voices already playing keep their own reference and finish naturally
+    publishSample(empty);
+}
 
-    sampleBuffer.setSize(numChannels, sampleLength);
-    reader->read(&sampleBuffer, 0, sampleLength, 0, true, true);
+bool SamplePlayback::hasSample() const
+{
+    const juce::ScopedLock sl(publishLock);
+    return !publishedSample->isEmpty();
+}
 
-    return true;
+void SamplePlayback::publishSample(SampleData::Ptr newSample)
+{
+    // Register first so the pool owns a reference before the audio thread can see it
+    releasePool->add(newSample);
+
+    const juce::ScopedLock sl(publishLock);
+
+    // Only swap while the audio thread is not holding the slot (at most one block)
+    for (;;)
+    {
+        auto* expected = sampleSlot.load(std::memory_order_acquire);
+
+        if (expected != nullptr
+            && sampleSlot.compare_exchange_weak(expected, newSample.get(), std::memory_order_acq_rel))
+            break;
+
+        juce::Thread::yield();
+    }
+
+    // Dropping our reference lets the release pool free the old sample once idle
+    publishedSample = newSample;
 }
 
-void SamplePlayback::clearSample()
+SampleData::Ptr SamplePlayback::convertToSessionRate(const SampleData::Ptr& source, double targetRate)
 {
-    stopAllVoices();
-    sampleBuffer.clear();
-    sampleLength = 0;
-    numChannels = 0;
+    if (targetRate <= 0.0 || source->isEmpty()
+        || juce::approximatelyEqual(source->getSourceSampleRate(), targetRate))
+        return source;
+
+    // A previous session may already have paid for this conversion
+    if (auto cached = convertedCache.load(source->getContentHash(), targetRate, source->getStorageFormat()))
+        return cached;
+
+    auto converted = resampler.process(source->toFloatBuffer(), source->getSourceSampleRate(), targetRate);
+    convertedCache.store(source->getContentHash(), targetRate, converted);
+
+    return new SampleData(std::move(converted), targetRate, source->getStorageFormat(), source->getContentHash());
+}
+
+void SamplePlayback::publishForSessionRate(const SampleData::Ptr& source)
+{
+    auto targetRate = sessionSampleRate.load();
+    auto ready = convertToSessionRate(source, targetRate);
+
+    // A newer load or rate change may have finished first; never publish stale audio
+    const juce::ScopedLock sl(publishLock);
+
+    if (source == sourceSample && targetRate == sessionSampleRate.load())
+        publishSample(ready);
+}
+
+void SamplePlayback::scheduleRateConversion()
+{
+    loaderPool->addJob(new SampleJob(*this, "Sample Rate Conversion",
+        [this]
+        {
+            SampleData::Ptr source;
+
+            {
+                const juce::ScopedLock sl(publishLock);
+                source = sourceSample;
+            }
+
+            publishForSessionRate(source);
+        }), true);
 }
 
 int SamplePlayback::findAvailableVoice()
@@ -255,12 +450,14 @@ int SamplePlayback::findAvailableVoice()
     return 0;
 }
 
-void SamplePlayback::startVoice(int voiceIndex, int midiNote, float velocity, float pitch)
+void SamplePlayback::startVoice(int voiceIndex, SampleData* sample, int midiNote, float velocity, float pitch)
 {
     auto& voice = voices[voiceIndex];
 
     voice.isActive = true;
     voice.isReleasing = false;
+    voice.sample = sample;
+    voice.cache.blockIndex = -1;
     voice.currentPosition = 0;
     voice.pitch = pitch;
     voice.gain = 1.0f;
@@ -287,20 +484,26 @@ void SamplePlayback::stopAllVoices()
     {
         voice.isActive = false;
         voice.isReleasing = false;
+        voice.sample = nullptr;
         voice.envelope.reset();
     }
 }
 
-float SamplePlayback::getSampleValue(int channel, float position)
+float SamplePlayback::getSampleValue(const SampleData& sample, BlockCache& cache, int channel, float position)
 {
-    if (!hasSample() || channel >= numChannels)
+    if (sample.isEmpty() || channel >= sample.getNumChannels())
         return 0.0f;
 
-    return interpolateSample(channel, position);
+    if (sample.isCompressed())
+        return interpolateCompressedSample(sample, cache, channel, position);
+
+    return interpolateSample(sample, channel, position);
 }
 
-float SamplePlayback::interpolateSample(int channel, float position)
+float SamplePlayback::interpolateSample(const SampleData& sample, int channel, float position)
 {
+    auto sampleLength = sample.getNumFrames();
+
     if (position < 0.0f || position >= sampleLength - 1)
         return 0.0f;
 
@@ -308,11 +511,43 @@ float SamplePlayback::interpolateSample(int channel, float position)
     int index2 = index1 + 1;
     float fraction = position - index1;
 
+    const auto& data = sample.getBuffer();
+
     if (index2 >= sampleLength)
-        return sampleBuffer.getSample(channel, index1);
+        return data.getSample(channel, index1);
+
+    float sample1 = data.getSample(channel, index1);
+    float sample2 = data.getSample(channel, index2);
+
+    // Linear interpolation
+    return sample1 + fraction * (sample2 - sample1);
+}
 
-    float sample1 = sampleBuffer.getSample(channel, index1);
-    float sample2 = sampleBuffer.getSample(channel, index2);
+float SamplePlayback::interpolateCompressedSample(const SampleData& sample, BlockCache& cache,
+    int channel, float position)
+{
+    if (position < 0.0f || position >= sample.getNumFrames() - 1 || channel >= maxCachedChannels)
+        return 0.0f;
+
+    int index1 = static_cast<int>(position);
+    int blockIndex = index1 / SampleData::blockSize;
+    float fraction = position - index1;
+
+    // Decode the next block only when the voice crosses into it
+    if (cache.blockIndex != blockIndex)
+    {
+        for (int ch = 0; ch < juce::jmin(sample.getNumChannels(), maxCachedChannels); ++ch)
+            sample.decodeBlock(ch, blockIndex, cache.frames[static_cast<size_t>(ch)].data());
+
+        cache.blockIndex = blockIndex;
+    }
+
+    // Each cached block carries one extra frame, so index2 is always in range
+    const auto& frames = cache.frames[static_cast<size_t>(channel)];
+    int offset = index1 - blockIndex * SampleData::blockSize;
+
+    float sample1 = frames[static_cast<size_t>(offset)];
+    float sample2 = frames[static_cast<size_t>(offset + 1)];
 
     // Linear interpolation
     return sample1 + fraction * (sample2 - sample1);
@@ -326,4 +561,4 @@ float SamplePlayback::noteToFrequency(int midiNote)
 float SamplePlayback::frequencyToPitchRatio(float targetFreq, float baseFreq)
 {
     return targetFreq / baseFreq;
-}
\ No newline at end of file
+}
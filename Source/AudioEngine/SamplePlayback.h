@@ -1,6 +1,11 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockParameters.h"
+#include "SampleData.h"
+#include "OfflineResampler.h"
+#include "ConvertedSampleCache.h"
+#include "GranularEngine.h"
 
 class SamplePlayback
 {
@@ -11,28 +16,79 @@ public:
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-        juce::AudioProcessorValueTreeState& apvts);
+        const BlockParameters& parameters);
 
-    // Sample management
+    // Seeds the granular scatter
+    void setSeed(juce::int64 newSeed) { granular.setSeed(newSeed); }
+
+    // Sample management (message or loader thread; never blocks the audio thread)
     bool loadSample(const juce::File& file);
     bool loadSample(const void* data, size_t dataSize);
+    void loadSampleAsync(const juce::File& file, std::function<void(bool)> onLoaded = nullptr);
     void clearSample();
-    bool hasSample() const { return sampleBuffer.getNumSamples() > 0; }
+    bool hasSample() const;
+
+    // Applies to samples loaded after the call
+    void setStorageFormat(SampleData::StorageFormat format) { storageFormat.store(format); }
+    SampleData::StorageFormat getStorageFormat() const { return storageFormat.load(); }
 
 private:
     // Audio processing
     double currentSampleRate = 44100.0;
     int currentBlockSize = 512;
 
-    // Sample data
-    juce::AudioBuffer<float> sampleBuffer;
-    int sampleLength = 0;
-    int numChannels = 0;
+    // Sample data. The slot always holds a valid sample except while the audio
+    // thread has taken it for the current block; writers wait for it to come back
+    // before swapping, so the audio thread never sees a sample being replaced.
+    std::atomic<SampleData*> sampleSlot{ nullptr };
+    SampleData::Ptr publishedSample;
+    juce::CriticalSection publishLock;
+
+    juce::SharedResourcePointer<SampleReleasePool> releasePool;
+    juce::SharedResourcePointer<SampleLoaderPool> loaderPool;
+    std::atomic<SampleData::StorageFormat> storageFormat{ SampleData::StorageFormat::float32 };
+
+    // Sample as decoded at its file rate; published samples are converted from it
+    SampleData::Ptr sourceSample;
+    std::atomic<double> sessionSampleRate{ 0.0 };
+
+    OfflineResampler resampler;
+    ConvertedSampleCache convertedCache;
+
+    class SampleJob;
+
+    // Takes the published sample for the duration of one audio block
+    struct ScopedSampleAccess
+    {
+        explicit ScopedSampleAccess(std::atomic<SampleData*>& s)
+            : slot(s), sample(s.exchange(nullptr, std::memory_order_acquire)) {}
+        ~ScopedSampleAccess() { slot.store(sample, std::memory_order_release); }
+
+        std::atomic<SampleData*>& slot;
+        SampleData* const sample;
+    };
+
+    void publishSample(SampleData::Ptr newSample);
+
+    // Load-time sample rate conversion (loader threads)
+    SampleData::Ptr convertToSessionRate(const SampleData::Ptr& source, double targetRate);
+    void publishForSessionRate(const SampleData::Ptr& source);
+    void scheduleRateConversion();
+
+    // Decoded frames of the block a voice is currently reading from a compressed sample
+    static constexpr int maxCachedChannels = 2;
+
+    struct BlockCache
+    {
+        int blockIndex = -1;
+        std::array<std::array<float, SampleData::blockSize + 1>, maxCachedChannels> frames;
+    };
 
     // Playback state
     struct Voice
     {
         bool isActive = false;
+        SampleData::Ptr sample;  // keeps the sample alive until the voice finishes
         int currentPosition = 0;
         float pitch = 1.0f;
         float gain = 1.0f;
@@ -42,6 +98,8 @@ private:
         // Envelope for sample playback
         juce::ADSR envelope;
         bool isReleasing = false;
+
+        BlockCache cache;
     };
 
     static constexpr int maxVoices = 16;
@@ -50,6 +108,22 @@ private:
     // ADSR parameters for sample envelope
     juce::ADSR::Parameters envelopeParams;
 
+    // Granular mode (SAMPLE_MODE == 1) renders through this instead of the voices
+    GranularEngine granular;
+    bool granularMode = false;
+    int granularNote = -1;
+
+    // Schema positions of the parameters read each block, resolved in prepare()
+    int enableIndex = -1;
+    int gainIndex = -1;
+    int pitchIndex = -1;
+    int modeIndex = -1;
+    int grainDensityIndex = -1;
+    int grainSizeIndex = -1;
+    int grainPositionIndex = -1;
+    int grainJitterIndex = -1;
+    int grainSprayIndex = -1;
+
     // Parameter smoothing
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::LinearSmoothedValue<float> pitchSmoother;
@@ -59,22 +133,27 @@ private:
     float currentPitch = 1.0f;
 
     // MIDI handling
-    void processMidiNote(int midiNote, bool isNoteOn, float velocity);
+    void processMidiNote(SampleData* sample, int midiNote, bool isNoteOn, float velocity);
+    void processGranularNote(int midiNote, bool isNoteOn, float velocity);
     void processMidiCC(int ccNumber, float ccValue);
 
     // Voice management
     int findAvailableVoice();
-    void startVoice(int voiceIndex, int midiNote, float velocity, float pitch);
+    void startVoice(int voiceIndex, SampleData* sample, int midiNote, float velocity, float pitch);
     void stopVoice(int voiceIndex);
     void stopAllVoices();
 
     // Sample playback
-    float getSampleValue(int channel, float position);
-    float interpolateSample(int channel, float position);
+    float getSampleValue(const SampleData& sample, BlockCache& cache, int channel, float position);
+    float interpolateSample(const SampleData& sample, int channel, float position);
+    float interpolateCompressedSample(const SampleData& sample, BlockCache& cache, int channel, float position);
 
     // Utility functions
     float noteToFrequency(int midiNote);
     float frequencyToPitchRatio(float targetFreq, float baseFreq = 440.0f);
 
+    // Drives the kernels above in Benchmarks/GeneratorKernelBenchmarks.cpp
+    friend struct GeneratorKernelAccess;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SamplePlayback)
 };
\ No newline at end of file
@@ -19,6 +19,11 @@ void ServoWhine::prepare(double sampleRate, int samplesPerBlock)
     currentSampleRate = sampleRate;
     currentBlockSize = samplesPerBlock;
 
+    enableIndex = BlockParameters::indexOf("SERVO_ENABLE");
+    gainIndex = BlockParameters::indexOf("SERVO_GAIN");
+    speedIndex = BlockParameters::indexOf("SERVO_SPEED");
+    whineIndex = BlockParameters::indexOf("SERVO_WHINE");
+
     // Prepare filters for servo sound shaping
     juce::dsp::ProcessSpec spec;
     spec.sampleRate = sampleRate;
@@ -57,15 +62,15 @@ void ServoWhine::reset()
 }
 
 void ServoWhine::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-    juce::AudioProcessorValueTreeState& apvts)
+    const BlockParameters& parameters)
 {
     // Get parameters
-    bool enabled = *apvts.getRawParameterValue("SERVO_ENABLE");
+    bool enabled = parameters.get(enableIndex) >= 0.5f;
     if (!enabled) return;
 
-    float gain = *apvts.getRawParameterValue("SERVO_GAIN");
-    float speed = *apvts.getRawParameterValue("SERVO_SPEED");
-    float whine = *apvts.getRawParameterValue("SERVO_WHINE");
+    float gain = parameters.get(gainIndex);
+    float speed = parameters.get(speedIndex);
+    float whine = parameters.get(whineIndex);
 
     // Update smoothed parameters
     gainSmoother.setTargetValue(gain);
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "BlockParameters.h"
 
 class ServoWhine
 {
@@ -11,7 +12,7 @@ public:
     void prepare(double sampleRate, int samplesPerBlock);
     void reset();
     void processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages,
-        juce::AudioProcessorValueTreeState& apvts);
+        const BlockParameters& parameters);
 
 private:
     // Audio processing
@@ -37,6 +38,12 @@ private:
     float currentWhine = 0.0f;
     float targetSpeed = 0.0f;
 
+    // Schema positions of the parameters read each block, resolved in prepare()
+    int enableIndex = -1;
+    int gainIndex = -1;
+    int speedIndex = -1;
+    int whineIndex = -1;
+
     // Parameter smoothing
     juce::LinearSmoothedValue<float> gainSmoother;
     juce::LinearSmoothedValue<float> speedSmoother;
@@ -54,5 +61,8 @@ private:
     float generateMotorNoise();
     float generateGearResonance();
 
+    // Drives the kernels above in Benchmarks/GeneratorKernelBenchmarks.cpp
+    friend struct GeneratorKernelAccess;
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ServoWhine)
 };
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "TraceRecorder.h"
+
+namespace
+{
+    constexpr int overrunCheckHz = 5;
+    constexpr juce::uint32 minDumpIntervalMs = 5000;
+}
+
+TraceRecorder::TraceRecorder()
+{
+}
+
+TraceRecorder::~TraceRecorder()
+{
+    stopTimer();
+}
+
+void TraceRecorder::setOverrunDumpDirectory(const juce::File& directory)
+{
+    dumpDirectory = directory;
+
+    if (dumpDirectory == juce::File())
+        stopTimer();
+    else
+        startTimerHz(overrunCheckHz);
+}
+
+std::vector<TraceRecorder::Event> TraceRecorder::getSnapshot() const
+{
+    auto end = writeIndex.load(std::memory_order_acquire);
+    auto begin = end > static_cast<juce::uint64>(capacity) ? end - capacity : 0;
+
+    std::vector<Event> snapshot;
+    snapshot.reserve(static_cast<size_t>(end - begin));
+
+    for (auto i = begin; i < end; ++i)
+        snapshot.push_back(events[static_cast<size_t>(i & (capacity - 1))]);
+
+    // Drop whatever the audio thread may have overwritten while we copied,
+    // including the slot it could be writing right now
+    auto after = writeIndex.load(std::memory_order_acquire);
+    auto firstIntact = after + 1 > static_cast<juce::uint64>(capacity) ? after + 1 - capacity : 0;
+
+    if (firstIntact > begin)
+        snapshot.erase(snapshot.begin(), snapshot.begin()
+            + static_cast<std::ptrdiff_t>(juce::jmin(firstIntact - begin, static_cast<juce::uint64>(snapshot.size()))));
+
+    return snapshot;
+}
+
+juce::String TraceRecorder::toChromeJson(const std::vector<Event>& snapshot)
+{
+    juce::MemoryOutputStream json;
+    json << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    auto ticksPerMicrosecond = static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / 1.0e6;
+    auto origin = snapshot.empty() ? 0 : snapshot.front().ticks;
+    int depth = 0;
+    bool first = true;
+
+    for (const auto& event : snapshot)
+    {
+        // The window may open inside a scope; its end has no begin
+        if (event.phase == 'E' && depth == 0)
+            continue;
+
+        depth += event.phase == 'B' ? 1 : event.phase == 'E' ? -1 : 0;
+
+        if (!first)
+            json << ",\n";
+
+        first = false;
+        json << "{\"name\":\"" << event.name << "\",\"ph\":\"" << juce::String::charToString(event.phase)
+             << "\",\"ts\":" << juce::String(static_cast<double>(event.ticks - origin) / ticksPerMicrosecond, 3)
+             << ",\"pid\":1,\"tid\":1";
+
+        if (event.phase == 'i')
+            json << ",\"s\":\"g\"";
+
+        json << "}";
+    }
+
+    json << "\n]}\n";
+    return json.toString();
+}
+
+bool TraceRecorder::writeChromeTrace(const juce::File& file) const
+{
+    file.getParentDirectory().createDirectory();
+    return file.replaceWithText(toChromeJson(getSnapshot()));
+}
+
+void TraceRecorder::writeChromeTraceAsync(const juce::File& file) const
+{
+    juce::Thread::launch([file, snapshot = getSnapshot()]
+    {
+        file.getParentDirectory().createDirectory();
+        file.replaceWithText(toChromeJson(snapshot));
+    });
+}
+
+void TraceRecorder::prepare(double sampleRate)
+{
+    ticksPerSample.store(static_cast<double>(juce::Time::getHighResolutionTicksPerSecond()) / sampleRate,
+        std::memory_order_relaxed);
+}
+
+void TraceRecorder::timerCallback()
+{
+    if (!overrunPending.exchange(false))
+        return;
+
+    auto now = juce::Time::getMillisecondCounter();
+    if (lastDumpMs != 0 && now - lastDumpMs < minDumpIntervalMs)
+        return;
+
+    lastDumpMs = now;
+    writeChromeTraceAsync(dumpDirectory.getChildFile("overrun " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S")
+        + ".json"));
+}
+
+//==============================================================================
+TraceRecorder::ScopedBlock::ScopedBlock(TraceRecorder& recorderToUse, int numSamples) noexcept
+    : recorder(recorderToUse)
+{
+    if (!recorder.isEnabled())
+        return;
+
+    start = juce::Time::getHighResolutionTicks();
+    budgetTicks = static_cast<juce::int64>(numSamples * recorder.ticksPerSample.load(std::memory_order_relaxed));
+    recorder.write("processBlock", 'B');
+}
+
+TraceRecorder::ScopedBlock::~ScopedBlock() noexcept
+{
+    if (start == 0)
+        return;
+
+    recorder.write("processBlock", 'E');
+
+    if (budgetTicks > 0 && juce::Time::getHighResolutionTicks() - start > budgetTicks)
+    {
+        recorder.write("overrun", 'i');
+        recorder.overrunPending.store(true, std::memory_order_relaxed);
+    }
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Set to 0 to compile the trace scopes out entirely
+#ifndef GUNDAM_ENABLE_TRACING
+ #define GUNDAM_ENABLE_TRACING 1
+#endif
+
+// Records what processBlock did, for when a host reports dropouts.
+//
+// The audio thread writes begin/end markers into a fixed ring of events: one
+// slot write and one index store, no locks and no allocation. Scopes check
+// whether recording is on once, when they open, so while it is off a scope
+// costs one relaxed load and two branches. Any other thread can take
+// a snapshot of the most recent events and write it as Chrome trace JSON, which
+// Perfetto and chrome://tracing open directly.
+//
+// Blocks that take longer than their real-time budget are marked as overruns.
+// With a dump directory set, the recorder writes a trace file shortly after each
+// overrun (at most one every few seconds) from a background thread.
+class TraceRecorder : private juce::Timer
+{
+public:
+    struct Event
+    {
+        const char* name = nullptr; // string literal
+        juce::int64 ticks = 0;
+        char phase = 'B';           // 'B'egin, 'E'nd or 'i'nstant
+    };
+
+    static constexpr int capacity = 1 << 15;
+
+    TraceRecorder();
+    ~TraceRecorder() override;
+
+    // Any thread
+    void setEnabled(bool shouldRecord) { enabled.store(shouldRecord, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+
+    // Message thread. An empty directory turns automatic dumps off.
+    void setOverrunDumpDirectory(const juce::File& directory);
+
+    // Any thread but the audio thread
+    std::vector<Event> getSnapshot() const;
+    static juce::String toChromeJson(const std::vector<Event>& snapshot);
+    bool writeChromeTrace(const juce::File& file) const;
+
+    // Takes the snapshot now and writes it on a background thread
+    void writeChromeTraceAsync(const juce::File& file) const;
+
+    // Audio thread
+    void prepare(double sampleRate);
+
+    void record(const char* name, char phase) noexcept
+    {
+        if (isEnabled())
+            write(name, phase);
+    }
+
+    // Wraps a whole processBlock and checks it against the block's budget
+    class ScopedBlock
+    {
+    public:
+        ScopedBlock(TraceRecorder& recorderToUse, int numSamples) noexcept;
+        ~ScopedBlock() noexcept;
+
+    private:
+        TraceRecorder& recorder;
+        juce::int64 start = 0;
+        juce::int64 budgetTicks = 0;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedBlock)
+    };
+
+    // The end marker is written only if the begin marker was, so a scope that
+    // straddles setEnabled() stays balanced
+    class ScopedTrace
+    {
+    public:
+        ScopedTrace(TraceRecorder& recorderToUse, const char* nameToUse) noexcept
+            : recorder(recorderToUse), name(nameToUse), active(recorder.isEnabled())
+        {
+            if (active)
+                recorder.write(name, 'B');
+        }
+
+        ~ScopedTrace() noexcept
+        {
+            if (active)
+                recorder.write(name, 'E');
+        }
+
+    private:
+        TraceRecorder& recorder;
+        const char* name;
+        const bool active;
+
+        JUCE_DECLARE_NON_COPYABLE(ScopedTrace)
+    };
+
+private:
+    void timerCallback() override;
+
+    void write(const char* name, char phase) noexcept
+    {
+        auto index = writeIndex.load(std::memory_order_relaxed);
+        auto& event = events[static_cast<size_t>(index & (capacity - 1))];
+        event.name = name;
+        event.ticks = juce::Time::getHighResolutionTicks();
+        event.phase = phase;
+        writeIndex.store(index + 1, std::memory_order_release);
+    }
+
+    std::atomic<bool> enabled{ false };
+    std::array<Event, capacity> events;
+    std::atomic<juce::uint64> writeIndex{ 0 };
+
+    std::atomic<double> ticksPerSample{ 0.0 };
+    std::atomic<bool> overrunPending{ false };
+
+    // Message thread
+    juce::File dumpDirectory;
+    juce::uint32 lastDumpMs = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TraceRecorder)
+};
+
+#if GUNDAM_ENABLE_TRACING
+ #define GUNDAM_TRACE_SCOPE(recorder, name) TraceRecorder::ScopedTrace JUCE_JOIN_MACRO(traceScope_, __LINE__)(recorder, name)
+ #define GUNDAM_TRACE_BLOCK(recorder, numSamples) TraceRecorder::ScopedBlock JUCE_JOIN_MACRO(traceBlock_, __LINE__)(recorder, numSamples)
+#else
+ #define GUNDAM_TRACE_SCOPE(recorder, name)
+ #define GUNDAM_TRACE_BLOCK(recorder, numSamples)
+#endif
@@ -0,0 +1,81 @@
+#include "UiCommandQueue.h"
+
+bool UiCommandQueue::trigger(int target, int note, float velocity, double lengthSeconds)
+{
+    auto sampleRate = publishedSampleRate.load(std::memory_order_relaxed);
+
+    Command command;
+    command.target = target;
+    command.note = juce::jlimit(0, 127, note);
+    command.velocity = juce::jlimit(0.0f, 1.0f, velocity);
+    command.length = static_cast<juce::int64>(juce::jmax(0.0, lengthSeconds) * sampleRate);
+
+    // Now on the audio clock, plus a block so it is never late
+    auto now = juce::Time::getMillisecondCounterHiRes() * 0.001;
+    command.time = static_cast<juce::int64>((now - clockOriginSeconds.load(std::memory_order_relaxed)) * sampleRate)
+                 + latencySamples.load(std::memory_order_relaxed);
+
+    int start1, size1, start2, size2;
+    commandFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    commands[static_cast<size_t>(size1 > 0 ? start1 : start2)] = command;
+    commandFifo.finishedWrite(1);
+    return true;
+}
+
+void UiCommandQueue::prepare(double sampleRate, int samplesPerBlock)
+{
+    sampleClock = 0;
+    clockStarted = false;
+    maxLeadSamples = static_cast<juce::int64>(sampleRate);
+    maxLateSamples = static_cast<juce::int64>(sampleRate * 0.5);
+
+    for (auto& pending : pendingOffs)
+        pending.target = -1;
+
+    latencySamples.store(samplesPerBlock, std::memory_order_relaxed);
+    publishedSampleRate.store(sampleRate, std::memory_order_relaxed);
+}
+
+void UiCommandQueue::publishClock()
+{
+    auto sampleRate = publishedSampleRate.load(std::memory_order_relaxed);
+    if (sampleRate <= 0.0)
+        return;
+
+    auto origin = juce::Time::getMillisecondCounterHiRes() * 0.001 - static_cast<double>(sampleClock) / sampleRate;
+
+    // Callback timing wobbles; the audio clock does not
+    if (clockStarted)
+    {
+        auto previous = clockOriginSeconds.load(std::memory_order_relaxed);
+        origin = previous + (origin - previous) * 0.05;
+    }
+
+    clockOriginSeconds.store(origin, std::memory_order_relaxed);
+    clockStarted = true;
+}
+
+void UiCommandQueue::addPendingOff(int target, int note, juce::int64 time)
+{
+    PendingOff* slot = nullptr;
+
+    for (auto& pending : pendingOffs)
+    {
+        // A retrigger of the same note moves its release
+        if (pending.target == target && pending.note == note)
+        {
+            slot = &pending;
+            break;
+        }
+
+        if (slot == nullptr && pending.target < 0)
+            slot = &pending;
+    }
+
+    if (slot != nullptr)
+        *slot = { target, note, time };
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Triggers from the editor to the audio thread.
+//
+// The message thread is the only producer and processBlock the only consumer:
+// an AbstractFifo over a fixed array, so both sides are wait-free and nothing is
+// allocated after construction. Commands carry plain values only; anything that
+// needs memory (a decoded sample, say) is prepared by the sender and published
+// through its own slot.
+//
+// Each command is stamped with the audio sample time it should start at. The
+// audio thread publishes where its sample clock sits in wall-clock time every
+// block, and the sender adds one block of latency to "now" on that clock, so a
+// click sounds a fixed time later rather than at whichever block boundary comes
+// next. Note-offs for triggers with a length are kept on the audio side.
+class UiCommandQueue
+{
+public:
+    UiCommandQueue() = default;
+
+    // Message thread. Returns false if the queue is full.
+    bool trigger(int target, int note, float velocity, double lengthSeconds);
+
+    void prepare(double sampleRate, int samplesPerBlock);
+
+    // Audio thread, once per block. Calls addMidi(target, message, sampleOffset)
+    // for every note that falls in this block.
+    template <typename AddMidi>
+    void process(int numSamples, AddMidi&& addMidi)
+    {
+        publishClock();
+
+        const auto blockEnd = sampleClock + numSamples;
+
+        for (auto& pending : pendingOffs)
+        {
+            if (pending.target >= 0 && pending.time < blockEnd)
+            {
+                addMidi(pending.target, juce::MidiMessage::noteOff(1, pending.note), offsetOf(pending.time, numSamples));
+                pending.target = -1;
+            }
+        }
+
+        while (commandFifo.getNumReady() > 0)
+        {
+            int start1, size1, start2, size2;
+            commandFifo.prepareToRead(1, start1, size1, start2, size2);
+            const auto& command = commands[static_cast<size_t>(size1 > 0 ? start1 : start2)];
+
+            // Later commands wait behind this one
+            if (command.time >= blockEnd && command.time - sampleClock < maxLeadSamples)
+                break;
+
+            // Left over from while the audio was stopped
+            if (sampleClock - command.time <= maxLateSamples)
+            {
+                addMidi(command.target, juce::MidiMessage::noteOn(1, command.note, command.velocity),
+                    offsetOf(command.time, numSamples));
+
+                if (command.length > 0)
+                    addPendingOff(command.target, command.note, juce::jmax(command.time, sampleClock) + command.length);
+            }
+
+            commandFifo.finishedRead(1);
+        }
+
+        sampleClock = blockEnd;
+    }
+
+private:
+    struct Command
+    {
+        int target = 0;
+        int note = 0;
+        float velocity = 0.0f;
+        juce::int64 time = 0;
+        juce::int64 length = 0;
+    };
+
+    struct PendingOff
+    {
+        int target = -1;
+        int note = 0;
+        juce::int64 time = 0;
+    };
+
+    static constexpr int queueSize = 256;
+    static constexpr int maxPendingOffs = 32;
+
+    void publishClock();
+    void addPendingOff(int target, int note, juce::int64 time);
+
+    int offsetOf(juce::int64 time, int numSamples) const
+    {
+        return static_cast<int>(juce::jlimit(static_cast<juce::int64>(0), static_cast<juce::int64>(numSamples - 1), time - sampleClock));
+    }
+
+    // Message thread -> audio thread
+    juce::AbstractFifo commandFifo{ queueSize };
+    std::array<Command, queueSize> commands;
+
+    // Audio thread -> message thread: the wall-clock time, in seconds, at which
+    // sample zero would have played, smoothed across blocks
+    std::atomic<double> clockOriginSeconds{ 0.0 };
+    std::atomic<double> publishedSampleRate{ 0.0 };
+    std::atomic<int> latencySamples{ 0 };
+
+    // Audio thread state
+    juce::int64 sampleClock = 0;
+    bool clockStarted = false;
+    juce::int64 maxLeadSamples = 0;
+    juce::int64 maxLateSamples = 0;
+    std::array<PendingOff, maxPendingOffs> pendingOffs;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(UiCommandQueue)
+};
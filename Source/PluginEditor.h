@@ -2,22 +2,29 @@
 
 #include <JuceHeader.h>
 #include "PluginProcessor.h"
+#include "UI/ModuleTabs/ModuleTabs.h"
+#include "UI/LevelMeters/LevelMeters.h"
+#include "UI/Analyser/SpectrumAnalyser.h"
+#include "UI/CpuLoad/CpuLoadView.h"
+#include "UI/PaintProfiler/PaintProfiler.h"
 
 //==============================================================================
 /**
 */
-class GUNDAM_PluginAudioProcessor : public juce::AudioProcessorEditor,
+class GUNDAM_PluginAudioProcessorEditor : public juce::AudioProcessorEditor,
     public juce::Slider::Listener,
     public juce::Button::Listener,
-    public juce::ComboBox::Listener
+    public juce::ComboBox::Listener,
+    private juce::Timer
 {
 public:
-    GUNDAM_PluginAudioProcessor(MechaMovementAudioProcessor&);
-    ~GUNDAM_PluginAudioProcessor() override;
+    GUNDAM_PluginAudioProcessorEditor(GUNDAM_PluginAudioProcessor&);
+    ~GUNDAM_PluginAudioProcessorEditor() override;
 
     //==============================================================================
     void paint(juce::Graphics&) override;
     void resized() override;
+    void mouseDoubleClick(const juce::MouseEvent& event) override;
 
     // Component listeners
     void sliderValueChanged(juce::Slider* slider) override;
@@ -26,68 +33,61 @@ public:
 
 private:
     // Reference to processor
-    MechaMovementAudioProcessor& audioProcessor;
+    GUNDAM_PluginAudioProcessor& audioProcessor;
+
+    // Generator controls, one tab each, built on first use
+    ModuleTabs moduleTabs;
 
     // UI Components
-    juce::GroupComponent hydraulicGroup, servoGroup, metalGroup, gearGroup, sampleGroup, masterGroup;
-
-    // Hydraulic Hiss Controls
-    juce::Slider hydraulicIntensitySlider, hydraulicFilterSlider, hydraulicGainSlider;
-    juce::Label hydraulicIntensityLabel, hydraulicFilterLabel, hydraulicGainLabel;
-    juce::ToggleButton hydraulicEnableButton;
-
-    // Servo Whine Controls
-    juce::Slider servoFreqSlider, servoModDepthSlider, servoGainSlider;
-    juce::Label servoFreqLabel, servoModDepthLabel, servoGainLabel;
-    juce::ToggleButton servoEnableButton;
-
-    // Metal Impact Controls
-    juce::Slider metalResonanceSlider, metalDecaySlider, metalGainSlider;
-    juce::Label metalResonanceLabel, metalDecayLabel, metalGainLabel;
-    juce::ToggleButton metalEnableButton;
-    juce::Button metalTriggerButton;
-
-    // Gear Grind Controls
-    juce::Slider gearRoughnessSlider, gearSpeedSlider, gearGainSlider;
-    juce::Label gearRoughnessLabel, gearSpeedLabel, gearGainLabel;
-    juce::ToggleButton gearEnableButton;
-
-    // Sample Playback Controls
-    juce::Slider sampleGainSlider, samplePitchSlider;
-    juce::Label sampleGainLabel, samplePitchLabel;
-    juce::ToggleButton sampleEnableButton;
-    juce::Button sampleTriggerButton;
-    juce::ComboBox sampleSelectCombo;
-    juce::Label sampleSelectLabel;
+    juce::GroupComponent masterGroup;
 
     // Master Controls
     juce::Slider masterGainSlider;
     juce::Label masterGainLabel;
     juce::ComboBox presetCombo;
     juce::Label presetLabel;
-    juce::Button savePresetButton, loadPresetButton;
+    juce::TextButton savePresetButton, loadPresetButton;
 
     // Macro Controls
     juce::Slider macro1Slider, macro2Slider, macro3Slider, macro4Slider;
     juce::Label macro1Label, macro2Label, macro3Label, macro4Label;
 
-    // Parameter attachments
+    // Generator and master levels
+    LevelMeters levelMeters;
+
+    // Processing cost per generator and for the whole block
+    CpuLoadView cpuLoadView;
+
+    // Output spectrum and scope
+    SpectrumAnalyser spectrumAnalyser;
+
+    // Background and title, rendered on resize only
+    juce::Image backgroundLayer;
+    void renderBackground();
+
+    // Parameter attachments for the controls that are always visible
     std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> sliderAttachments;
-    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment>> buttonAttachments;
-    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>> comboAttachments;
 
     // Helper methods
     void setupSlider(juce::Slider& slider, juce::Label& label, const juce::String& labelText);
-    void setupButton(juce::ToggleButton& button, const juce::String& buttonText);
     void setupComboBox(juce::ComboBox& combo, juce::Label& label, const juce::String& labelText);
     void createParameterAttachments();
 
+    // The one UI timer; everything that follows the audio thread refreshes from here
+    void timerCallback() override;
+    static constexpr int refreshTimerHz = 30;
+
     // Layout constants
     static constexpr int MARGIN = 10;
     static constexpr int GROUP_HEIGHT = 120;
     static constexpr int CONTROL_HEIGHT = 20;
-    static constexpr int SLIDER_WIDTH = 80;
     static constexpr int BUTTON_HEIGHT = 25;
+    static constexpr int TITLE_HEIGHT = 40;
+    static constexpr int MODULE_TABS_HEIGHT = 260;
+
+    // Double-click the title to show; declared last so it unhooks before the
+    // components it times are destroyed
+    PaintProfiler paintProfiler{ *this };
 
-    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GUNDAM_PluginAudioProcessor)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(GUNDAM_PluginAudioProcessorEditor)
 };
\ No newline at end of file
@@ -1,7 +1,8 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
+#include "Preset/PresetSerialization.h"
 
-GUNDAM_PluginAudioProcessor::GUNDAM_PluginAudioProcessor()
+GUNDAM_PluginAudioProcessor::GUNDAM_PluginAudioProcessor(Mode modeToUse)
 #ifndef JucePlugin_PreferredChannelConfigurations
     : AudioProcessor(BusesProperties()
 #if ! JucePlugin_IsMidiEffect
@@ -12,15 +13,36 @@ GUNDAM_PluginAudioProcessor::GUNDAM_PluginAudioProcessor()
 #endif
     ),
 #endif
-    apvts(*this, nullptr, "Parameters", createParameterLayout())
+    apvts(*this, nullptr, "Parameters", createParameterLayout()),
+    mode(modeToUse)
 {
-    // Initialize parameter pointers
-    masterGain = apvts.getRawParameterValue("MASTER_GAIN");
-    masterMix = apvts.getRawParameterValue("MASTER_MIX");
+    // Keep the cached host state chunk honest
+    for (auto* parameter : getParameters())
+        parameter->addListener(this);
+
+    apvts.state.addListener(this);
+
+    if (mode == Mode::plugin)
+    {
+        presetManager = std::make_unique<PresetManager>(apvts, morphEngine);
+        programBank = std::make_unique<ProgramBank>(*presetManager, morphEngine);
+
+        programBank->onProgramChanged = [this]
+        {
+            updateHostDisplay(ChangeDetails().withProgramChanged(true));
+        };
+    }
+
+    modulationMatrix.onChanged = [this] { markStateDirty(); };
+    movementSequencer.onChanged = [this] { markStateDirty(); };
 }
 
 GUNDAM_PluginAudioProcessor::~GUNDAM_PluginAudioProcessor()
 {
+    apvts.state.removeListener(this);
+
+    for (auto* parameter : getParameters())
+        parameter->removeListener(this);
 }
 
 const juce::String GUNDAM_PluginAudioProcessor::getName() const
@@ -62,21 +84,23 @@ double GUNDAM_PluginAudioProcessor::getTailLengthSeconds() const
 
 int GUNDAM_PluginAudioProcessor::getNumPrograms()
 {
-    return 1;
+    return programBank != nullptr ? programBank->getNumPrograms() : 1;
 }
 
 int GUNDAM_PluginAudioProcessor::getCurrentProgram()
 {
-    return 0;
+    return programBank != nullptr ? programBank->getCurrentProgram() : 0;
 }
 
 void GUNDAM_PluginAudioProcessor::setCurrentProgram(int index)
 {
+    if (programBank != nullptr)
+        programBank->selectProgram(index);
 }
 
 const juce::String GUNDAM_PluginAudioProcessor::getProgramName(int index)
 {
-    return {};
+    return programBank != nullptr ? programBank->getProgramName(index) : juce::String();
 }
 
 void GUNDAM_PluginAudioProcessor::changeProgramName(int index, const juce::String& newName)
@@ -91,9 +115,24 @@ void GUNDAM_PluginAudioProcessor::prepareToPlay(double sampleRate, int samplesPe
     metalImpactGen.prepare(sampleRate, samplesPerBlock);
     gearGrindGen.prepare(sampleRate, samplesPerBlock);
     samplePlayer.prepare(sampleRate, samplesPerBlock);
+    morphEngine.prepare(sampleRate, samplesPerBlock);
+    modulationMatrix.prepare(sampleRate, samplesPerBlock);
+    movementSequencer.prepare(sampleRate, samplesPerBlock);
+    uiCommands.prepare(sampleRate, samplesPerBlock);
+    traceRecorder.prepare(sampleRate);
+    emitterEngine.prepare(sampleRate, samplesPerBlock);
 
     // Prepare mix buffer
     mixBuffer.setSize(2, samplesPerBlock);
+    busBuffer.setSize(2, samplesPerBlock);
+
+    for (auto& meter : levelMeters)
+        meter.prepare(sampleRate);
+
+    analyserFeed.prepare(sampleRate);
+
+    for (auto& load : cpuLoads)
+        load.prepare(sampleRate);
 }
 
 void GUNDAM_PluginAudioProcessor::releaseResources()
@@ -103,6 +142,107 @@ void GUNDAM_PluginAudioProcessor::releaseResources()
     metalImpactGen.reset();
     gearGrindGen.reset();
     samplePlayer.reset();
+    emitterEngine.reset();
+    movementSequencer.reset();
+}
+
+void GUNDAM_PluginAudioProcessor::triggerMetalImpact()
+{
+    // MetalImpact answers notes from E4 up
+    uiCommands.trigger(metalBus, 72, 1.0f, 0.25);
+}
+
+void GUNDAM_PluginAudioProcessor::triggerSample()
+{
+    // Released after a while so granular mode closes its gate
+    uiCommands.trigger(sampleBus, 60, 1.0f, 0.5);
+}
+
+void GUNDAM_PluginAudioProcessor::setSampleIndex(int index)
+{
+    auto file = getSampleFile(index);
+    if (!file.existsAsFile())
+        return;
+
+    // Decoded and converted on a loader thread, then swapped in lock-free. The
+    // index only changes once the sample has loaded.
+    samplePlayer.loadSampleAsync(file, [safeThis = juce::WeakReference<GUNDAM_PluginAudioProcessor>(this), index](bool loaded)
+    {
+        if (loaded && safeThis != nullptr)
+        {
+            safeThis->sampleIndex.store(index);
+            safeThis->markStateDirty();
+        }
+    });
+}
+
+void GUNDAM_PluginAudioProcessor::setTracingEnabled(bool shouldTrace)
+{
+    if (shouldTrace == traceRecorder.isEnabled())
+        return;
+
+    auto directory = getTraceDirectory();
+
+    if (shouldTrace)
+    {
+        directory.createDirectory();
+        traceRecorder.setOverrunDumpDirectory(directory);
+        traceRecorder.setEnabled(true);
+        return;
+    }
+
+    traceRecorder.setEnabled(false);
+    traceRecorder.setOverrunDumpDirectory({});
+    traceRecorder.writeChromeTraceAsync(directory.getChildFile("trace " + juce::Time::getCurrentTime().formatted("%Y-%m-%d %H-%M-%S")
+        + ".json"));
+}
+
+juce::File GUNDAM_PluginAudioProcessor::getTraceDirectory()
+{
+    auto userAppData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+    return userAppData.getChildFile("MechaMovementSoundGenerator").getChildFile("Traces");
+}
+
+juce::File GUNDAM_PluginAudioProcessor::getSampleFile(int index)
+{
+    static const char* const names[] = { "Mecha Step 1", "Mecha Step 2", "Hydraulic Release", "Metal Clank", "Servo Motor" };
+
+    if (!juce::isPositiveAndBelow(index, static_cast<int>(std::size(names))))
+        return {};
+
+    auto userAppData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
+    return userAppData.getChildFile("MechaMovementSoundGenerator").getChildFile("Samples")
+        .getChildFile(juce::String(names[index]) + ".wav");
+}
+
+MovementSequencer::Transport GUNDAM_PluginAudioProcessor::getTransport() const
+{
+    static_assert(MovementSequencer::numTargets == sampleBus + 1, "Sequencer targets must match the generator buses");
+
+    MovementSequencer::Transport transport;
+
+    if (auto* playHead = getPlayHead())
+    {
+        if (auto position = playHead->getPosition())
+        {
+            transport.playing = position->getIsPlaying();
+            transport.ppqPosition = position->getPpqPosition().orFallback(0.0);
+            transport.bpm = position->getBpm().orFallback(120.0);
+        }
+    }
+
+    return transport;
+}
+
+void GUNDAM_PluginAudioProcessor::setRandomSeed(juce::int64 seed)
+{
+    // A separate stream per generator so their noise does not correlate
+    auto streamSeed = [seed](juce::int64 stream) { return seed ^ (stream * 0x5851f42d4c957f2dLL); };
+
+    hydraulicGen.setSeed(streamSeed(1));
+    metalImpactGen.setSeed(streamSeed(2));
+    gearGrindGen.setSeed(streamSeed(3));
+    samplePlayer.setSeed(streamSeed(4));
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -129,6 +269,9 @@ bool GUNDAM_PluginAudioProcessor::isBusesLayoutSupported(const BusesLayout& layo
 void GUNDAM_PluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer, juce::MidiBuffer& midiMessages)
 {
     juce::ScopedNoDenormals noDenormals;
+    CpuLoadMeter::ScopedTimer blockTimer(cpuLoads[totalStage], buffer.getNumSamples());
+    GUNDAM_TRACE_BLOCK(traceRecorder, buffer.getNumSamples());
+
     auto totalNumInputChannels = getTotalNumInputChannels();
     auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -136,31 +279,67 @@ void GUNDAM_PluginAudioProcessor::processBlock(juce::AudioBuffer<float>& buffer,
     for (auto i = totalNumInputChannels; i < totalNumOutputChannels; ++i)
         buffer.clear(i, 0, buffer.getNumSamples());
 
+    {
+        GUNDAM_TRACE_SCOPE(traceRecorder, "MIDI and control");
+
+        // Advance any preset morph before the generators read their parameters
+        morphEngine.process(buffer.getNumSamples());
+        if (programBank != nullptr)
+            programBank->processMidi(midiMessages);
+        blockParameters.capture();
+        movementSequencer.process(getTransport(), buffer.getNumSamples(), blockParameters);
+
+        // Editor triggers go to their generator at the time they were stamped with
+        uiCommands.process(buffer.getNumSamples(), [this](int target, const juce::MidiMessage& message, int offset)
+        {
+            movementSequencer.addMidi(target, message, offset);
+        });
+
+        modulationMatrix.process(buffer, midiMessages, buffer.getNumSamples(), blockParameters);
+    }
+
     // Clear mix buffer
     mixBuffer.clear();
 
     // Process each sound generator
-    hydraulicGen.processBlock(mixBuffer, midiMessages, apvts);
-    servoGen.processBlock(mixBuffer, midiMessages, apvts);
-    metalImpactGen.processBlock(mixBuffer, midiMessages, apvts);
-    gearGrindGen.processBlock(mixBuffer, midiMessages, apvts);
-    samplePlayer.processBlock(mixBuffer, midiMessages, apvts);
+    renderBus(hydraulicGen, hydraulicBus, midiMessages, buffer.getNumSamples());
+    renderBus(servoGen, servoBus, midiMessages, buffer.getNumSamples());
+    renderBus(metalImpactGen, metalBus, midiMessages, buffer.getNumSamples());
+    renderBus(gearGrindGen, gearBus, midiMessages, buffer.getNumSamples());
+    renderBus(samplePlayer, sampleBus, midiMessages, buffer.getNumSamples());
+
+    // Scene emitters, if a game host has added any
+    {
+        GUNDAM_TRACE_SCOPE(traceRecorder, "Emitters");
+        emitterEngine.render(mixBuffer, buffer.getNumSamples());
+    }
 
     // Apply master gain and mix
-    float gain = masterGain->load();
-    float mix = masterMix->load();
+    float gain = blockParameters.get(masterGainIndex);
+    float mix = blockParameters.get(masterMixIndex);
 
-    for (int channel = 0; channel < totalNumOutputChannels; ++channel)
     {
-        auto* channelData = buffer.getWritePointer(channel);
-        auto* mixData = mixBuffer.getReadPointer(channel % mixBuffer.getNumChannels());
+        CpuLoadMeter::ScopedTimer mixTimer(cpuLoads[mixStage], buffer.getNumSamples());
+        GUNDAM_TRACE_SCOPE(traceRecorder, "Master mix");
 
-        for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+        for (int channel = 0; channel < totalNumOutputChannels; ++channel)
         {
-            float processedSample = mixData[sample] * gain;
-            channelData[sample] = channelData[sample] * (1.0f - mix) + processedSample * mix;
+            auto* channelData = buffer.getWritePointer(channel);
+            auto* mixData = mixBuffer.getReadPointer(channel % mixBuffer.getNumChannels());
+
+            for (int sample = 0; sample < buffer.getNumSamples(); ++sample)
+            {
+                float processedSample = mixData[sample] * gain;
+                channelData[sample] = channelData[sample] * (1.0f - mix) + processedSample * mix;
+            }
         }
     }
+
+    modulationMatrix.followOutput(buffer, buffer.getNumSamples());
+
+    GUNDAM_TRACE_SCOPE(traceRecorder, "Metering");
+    levelMeters[masterBus].measure(buffer, buffer.getNumSamples());
+    analyserFeed.push(buffer, buffer.getNumSamples());
 }
 
 bool GUNDAM_PluginAudioProcessor::hasEditor() const
@@ -175,18 +354,76 @@ juce::AudioProcessorEditor* GUNDAM_PluginAudioProcessor::createEditor()
 
 void GUNDAM_PluginAudioProcessor::getStateInformation(juce::MemoryBlock& destData)
 {
-    auto state = apvts.copyState();
-    std::unique_ptr<juce::XmlElement> xml(state.createXml());
-    copyXmlToBinary(*xml, destData);
+    const juce::ScopedLock sl(cachedStateLock);
+
+    // Hosts autosave often; only re-encode when something has changed. A change
+    // landing mid-encode leaves the cache marked older, so it is redone next time.
+    auto generation = stateGeneration.load(std::memory_order_relaxed);
+
+    if (generation != cachedStateGeneration || cachedState.isEmpty())
+    {
+        cachedState = PresetSerialization::toBinary(morphEngine.captureCurrent(), createSessionState());
+        cachedStateGeneration = generation;
+    }
+
+    destData = cachedState;
 }
 
 void GUNDAM_PluginAudioProcessor::setStateInformation(const void* data, int sizeInBytes)
 {
+    if (sizeInBytes <= 0)
+        return;
+
+    // Binary chunks go straight to a ValueTree without an XML DOM
+    if (PresetSerialization::isBinary(data, static_cast<size_t>(sizeInBytes)))
+    {
+        PresetSerialization::Preset preset;
+        if (PresetSerialization::fromBinary(data, static_cast<size_t>(sizeInBytes), preset))
+        {
+            apvts.replaceState(preset.state);
+            restoreSessionState(preset.session);
+        }
+
+        return;
+    }
+
+    // Sessions saved before the binary chunk
     std::unique_ptr<juce::XmlElement> xmlState(getXmlFromBinary(data, sizeInBytes));
 
     if (xmlState.get() != nullptr)
+    {
         if (xmlState->hasTagName(apvts.state.getType()))
+        {
             apvts.replaceState(juce::ValueTree::fromXml(*xmlState));
+            restoreSessionState({});
+        }
+    }
+}
+
+juce::ValueTree GUNDAM_PluginAudioProcessor::createSessionState() const
+{
+    juce::ValueTree session("SESSION", { { "sampleIndex", getSampleIndex() } });
+    session.appendChild(modulationMatrix.createState(), nullptr);
+    session.appendChild(movementSequencer.createState(), nullptr);
+    return session;
+}
+
+void GUNDAM_PluginAudioProcessor::restoreSessionState(const juce::ValueTree& session)
+{
+    // Anything missing goes back to its defaults
+    modulationMatrix.restoreState(session.getChildWithName(ModulationMatrix::stateType));
+    movementSequencer.restoreState(session.getChildWithName(MovementSequencer::stateType));
+
+    // The saved sample is reloaded in the background; without one, or if its
+    // file has gone, the player is left empty
+    auto savedSampleIndex = static_cast<int>(session.getProperty("sampleIndex", -1));
+
+    if (savedSampleIndex != getSampleIndex())
+    {
+        samplePlayer.clearSample();
+        sampleIndex.store(-1);
+        setSampleIndex(savedSampleIndex);
+    }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout GUNDAM_PluginAudioProcessor::createParameterLayout()
@@ -241,6 +478,28 @@ juce::AudioProcessorValueTreeState::ParameterLayout GUNDAM_PluginAudioProcessor:
     layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_PITCH", "Sample Pitch",
         juce::NormalisableRange<float>(0.25f, 4.0f, 0.01f), 1.0f));
     layout.add(std::make_unique<juce::AudioParameterBool>("SAMPLE_ENABLE", "Sample Enable", true));
+    layout.add(std::make_unique<juce::AudioParameterChoice>("SAMPLE_MODE", "Sample Mode",
+        juce::StringArray{ "Voices", "Granular" }, 0));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_GRAIN_DENSITY", "Grain Density",
+        juce::NormalisableRange<float>(1.0f, 400.0f, 0.1f, 0.4f), 20.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_GRAIN_SIZE", "Grain Size",
+        juce::NormalisableRange<float>(5.0f, 500.0f, 0.1f, 0.5f), 80.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_GRAIN_POSITION", "Grain Position",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_GRAIN_JITTER", "Grain Position Jitter",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.001f), 0.05f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("SAMPLE_GRAIN_SPRAY", "Grain Pitch Spray",
+        juce::NormalisableRange<float>(0.0f, 12.0f, 0.01f), 0.0f));
+
+    // Macros, routed to the generators by the modulation matrix
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MACRO_1", "Macro 1 - Movement Intensity",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MACRO_2", "Macro 2 - Mechanical Stress",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MACRO_3", "Macro 3 - Impact Force",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
+    layout.add(std::make_unique<juce::AudioParameterFloat>("MACRO_4", "Macro 4 - System Load",
+        juce::NormalisableRange<float>(0.0f, 1.0f, 0.01f), 0.0f));
 
     return layout;
 }
@@ -0,0 +1,203 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetSchema.h"
+
+// Built-in presets as compile-time tables of plain parameter values.
+// Each preset lists every schema parameter, in schema order, by ID; the
+// static_asserts below reject a table that is out of order, incomplete or out
+// of range, so adding a parameter to the schema forces these to be updated.
+namespace FactoryPresets
+{
+    struct Value
+    {
+        const char* parameterId;
+        float value;
+    };
+
+    struct Preset
+    {
+        const char* name;
+        Value values[PresetSchema::numParameters];
+    };
+
+    inline constexpr Preset presets[] = {
+        { "Default", {
+            { "MASTER_GAIN",           1.0f },
+            { "MASTER_MIX",            1.0f },
+            { "HYDRAULIC_GAIN",        0.6f },
+            { "HYDRAULIC_PRESSURE",    2.0f },
+            { "HYDRAULIC_FLOW",        1.0f },
+            { "HYDRAULIC_ENABLE",      1.0f },
+            { "SERVO_GAIN",            0.5f },
+            { "SERVO_SPEED",           20.0f },
+            { "SERVO_WHINE",           0.3f },
+            { "SERVO_ENABLE",          1.0f },
+            { "METAL_GAIN",            0.7f },
+            { "METAL_RESONANCE",       2.0f },
+            { "METAL_DECAY",           1.0f },
+            { "METAL_ENABLE",          1.0f },
+            { "GEAR_GAIN",             0.5f },
+            { "GEAR_ROUGHNESS",        0.5f },
+            { "GEAR_SPEED",            2.0f },
+            { "GEAR_ENABLE",           1.0f },
+            { "SAMPLE_GAIN",           0.6f },
+            { "SAMPLE_PITCH",          1.0f },
+            { "SAMPLE_ENABLE",         1.0f },
+            { "SAMPLE_MODE",           0.0f },
+            { "SAMPLE_GRAIN_DENSITY",  20.0f },
+            { "SAMPLE_GRAIN_SIZE",     80.0f },
+            { "SAMPLE_GRAIN_POSITION", 0.0f },
+            { "SAMPLE_GRAIN_JITTER",   0.05f },
+            { "SAMPLE_GRAIN_SPRAY",    0.0f },
+            { "MACRO_1",               0.0f },
+            { "MACRO_2",               0.0f },
+            { "MACRO_3",               0.0f },
+            { "MACRO_4",               0.0f },
+        } },
+
+        { "Heavy Mech", {
+            { "MASTER_GAIN",           1.2f },
+            { "MASTER_MIX",            1.0f },
+            { "HYDRAULIC_GAIN",        0.9f },
+            { "HYDRAULIC_PRESSURE",    7.5f },
+            { "HYDRAULIC_FLOW",        0.6f },
+            { "HYDRAULIC_ENABLE",      1.0f },
+            { "SERVO_GAIN",            0.8f },
+            { "SERVO_SPEED",           8.0f },
+            { "SERVO_WHINE",           0.2f },
+            { "SERVO_ENABLE",          1.0f },
+            { "METAL_GAIN",            1.0f },
+            { "METAL_RESONANCE",       6.5f },
+            { "METAL_DECAY",           3.5f },
+            { "METAL_ENABLE",          1.0f },
+            { "GEAR_GAIN",             0.9f },
+            { "GEAR_ROUGHNESS",        1.5f },
+            { "GEAR_SPEED",            1.0f },
+            { "GEAR_ENABLE",           1.0f },
+            { "SAMPLE_GAIN",           0.9f },
+            { "SAMPLE_PITCH",          0.6f },
+            { "SAMPLE_ENABLE",         1.0f },
+            { "SAMPLE_MODE",           0.0f },
+            { "SAMPLE_GRAIN_DENSITY",  20.0f },
+            { "SAMPLE_GRAIN_SIZE",     120.0f },
+            { "SAMPLE_GRAIN_POSITION", 0.0f },
+            { "SAMPLE_GRAIN_JITTER",   0.05f },
+            { "SAMPLE_GRAIN_SPRAY",    0.0f },
+            { "MACRO_1",               0.0f },
+            { "MACRO_2",               0.0f },
+            { "MACRO_3",               0.0f },
+            { "MACRO_4",               0.0f },
+        } },
+
+        { "Light Scout", {
+            { "MASTER_GAIN",           0.9f },
+            { "MASTER_MIX",            1.0f },
+            { "HYDRAULIC_GAIN",        0.4f },
+            { "HYDRAULIC_PRESSURE",    1.2f },
+            { "HYDRAULIC_FLOW",        3.5f },
+            { "HYDRAULIC_ENABLE",      1.0f },
+            { "SERVO_GAIN",            0.6f },
+            { "SERVO_SPEED",           70.0f },
+            { "SERVO_WHINE",           0.7f },
+            { "SERVO_ENABLE",          1.0f },
+            { "METAL_GAIN",            0.5f },
+            { "METAL_RESONANCE",       1.5f },
+            { "METAL_DECAY",           0.5f },
+            { "METAL_ENABLE",          1.0f },
+            { "GEAR_GAIN",             0.4f },
+            { "GEAR_ROUGHNESS",        0.3f },
+            { "GEAR_SPEED",            7.0f },
+            { "GEAR_ENABLE",           1.0f },
+            { "SAMPLE_GAIN",           0.5f },
+            { "SAMPLE_PITCH",          1.6f },
+            { "SAMPLE_ENABLE",         1.0f },
+            { "SAMPLE_MODE",           0.0f },
+            { "SAMPLE_GRAIN_DENSITY",  40.0f },
+            { "SAMPLE_GRAIN_SIZE",     40.0f },
+            { "SAMPLE_GRAIN_POSITION", 0.0f },
+            { "SAMPLE_GRAIN_JITTER",   0.05f },
+            { "SAMPLE_GRAIN_SPRAY",    0.0f },
+            { "MACRO_1",               0.0f },
+            { "MACRO_2",               0.0f },
+            { "MACRO_3",               0.0f },
+            { "MACRO_4",               0.0f },
+        } },
+
+        { "Battle Damaged", {
+            { "MASTER_GAIN",           1.3f },
+            { "MASTER_MIX",            1.0f },
+            { "HYDRAULIC_GAIN",        0.8f },
+            { "HYDRAULIC_PRESSURE",    8.5f },
+            { "HYDRAULIC_FLOW",        4.0f },
+            { "HYDRAULIC_ENABLE",      1.0f },
+            { "SERVO_GAIN",            0.7f },
+            { "SERVO_SPEED",           30.0f },
+            { "SERVO_WHINE",           0.9f },
+            { "SERVO_ENABLE",          1.0f },
+            { "METAL_GAIN",            0.9f },
+            { "METAL_RESONANCE",       8.0f },
+            { "METAL_DECAY",           4.5f },
+            { "METAL_ENABLE",          1.0f },
+            { "GEAR_GAIN",             0.8f },
+            { "GEAR_ROUGHNESS",        2.0f },
+            { "GEAR_SPEED",            6.0f },
+            { "GEAR_ENABLE",           1.0f },
+            { "SAMPLE_GAIN",           0.7f },
+            { "SAMPLE_PITCH",          0.8f },
+            { "SAMPLE_ENABLE",         1.0f },
+            { "SAMPLE_MODE",           1.0f },
+            { "SAMPLE_GRAIN_DENSITY",  60.0f },
+            { "SAMPLE_GRAIN_SIZE",     60.0f },
+            { "SAMPLE_GRAIN_POSITION", 0.3f },
+            { "SAMPLE_GRAIN_JITTER",   0.4f },
+            { "SAMPLE_GRAIN_SPRAY",    3.0f },
+            { "MACRO_1",               0.0f },
+            { "MACRO_2",               0.0f },
+            { "MACRO_3",               0.0f },
+            { "MACRO_4",               0.0f },
+        } },
+    };
+
+    inline constexpr int numPresets = static_cast<int>(std::size(presets));
+
+    constexpr bool matchesSchema(const Preset& preset)
+    {
+        for (int i = 0; i < PresetSchema::numParameters; ++i)
+        {
+            const auto& value = preset.values[i];
+            const auto& parameter = PresetSchema::parameters[i];
+
+            if (!PresetSchema::idsMatch(value.parameterId, parameter.parameterId)
+                || value.value < parameter.minValue || value.value > parameter.maxValue)
+                return false;
+        }
+
+        return true;
+    }
+
+    constexpr bool allMatchSchema()
+    {
+        for (const auto& preset : presets)
+            if (!matchesSchema(preset))
+                return false;
+
+        return true;
+    }
+
+    static_assert(allMatchSchema(), "Factory presets must list every schema parameter in order, within range");
+
+    // The values alone, ready to be copied into a morph snapshot
+    constexpr std::array<PresetSchema::Values, numPresets> makeValueTable()
+    {
+        std::array<PresetSchema::Values, numPresets> table{};
+
+        for (int p = 0; p < numPresets; ++p)
+            for (int i = 0; i < PresetSchema::numParameters; ++i)
+                table[static_cast<size_t>(p)][static_cast<size_t>(i)] = presets[p].values[i].value;
+
+        return table;
+    }
+
+    inline constexpr auto values = makeValueTable();
+}
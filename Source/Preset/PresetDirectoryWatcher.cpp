@@ -0,0 +1,131 @@
+#include "PresetDirectoryWatcher.h"
+#include "PresetSerialization.h"
+
+#if JUCE_LINUX
+ #include <sys/inotify.h>
+ #include <poll.h>
+ #include <unistd.h>
+#endif
+
+PresetDirectoryWatcher::PresetDirectoryWatcher(const juce::File& directoryToWatch)
+    : directory(directoryToWatch)
+{
+#if JUCE_LINUX
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    ensureWatching();
+#else
+    snapshot = takeSnapshot();
+#endif
+}
+
+PresetDirectoryWatcher::~PresetDirectoryWatcher()
+{
+#if JUCE_LINUX
+    if (inotifyFd >= 0)
+        close(inotifyFd);
+#endif
+}
+
+bool PresetDirectoryWatcher::isPresetFileName(const juce::String& fileName)
+{
+    return fileName.endsWithIgnoreCase(PresetSerialization::binaryExtension)
+        || fileName.endsWithIgnoreCase(PresetSerialization::legacyExtension);
+}
+
+#if JUCE_LINUX
+
+bool PresetDirectoryWatcher::ensureWatching()
+{
+    if (inotifyFd < 0)
+        return false;
+
+    // The presets directory may not exist until the first save
+    if (watchDescriptor < 0 && directory.isDirectory())
+        watchDescriptor = inotify_add_watch(inotifyFd, directory.getFullPathName().toRawUTF8(),
+            IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE | IN_DELETE_SELF);
+
+    return watchDescriptor >= 0;
+}
+
+juce::Array<juce::File> PresetDirectoryWatcher::waitForChanges(int timeoutMs)
+{
+    juce::Array<juce::File> changed;
+
+    if (!ensureWatching())
+    {
+        juce::Thread::sleep(timeoutMs);
+        return changed;
+    }
+
+    pollfd descriptor{ inotifyFd, POLLIN, 0 };
+    if (poll(&descriptor, 1, timeoutMs) <= 0)
+        return changed;
+
+    alignas(inotify_event) char events[4096];
+
+    for (;;)
+    {
+        auto bytesRead = read(inotifyFd, events, sizeof(events));
+        if (bytesRead <= 0)
+            break;
+
+        for (char* ptr = events; ptr < events + bytesRead;)
+        {
+            auto* event = reinterpret_cast<inotify_event*>(ptr);
+            ptr += sizeof(inotify_event) + event->len;
+
+            if ((event->mask & (IN_DELETE_SELF | IN_IGNORED)) != 0)
+            {
+                // Directory went away; start again when it is recreated
+                watchDescriptor = -1;
+                continue;
+            }
+
+            if (event->len > 0)
+            {
+                juce::String fileName(juce::CharPointer_UTF8(event->name));
+
+                if (isPresetFileName(fileName))
+                    changed.addIfNotAlreadyThere(directory.getChildFile(fileName));
+            }
+        }
+    }
+
+    return changed;
+}
+
+#else
+
+std::map<juce::String, juce::Time> PresetDirectoryWatcher::takeSnapshot() const
+{
+    std::map<juce::String, juce::Time> result;
+
+    for (const auto& entry : juce::RangedDirectoryIterator(directory, false, "*.mpreset;*.preset", juce::File::findFiles))
+        result[entry.getFile().getFullPathName()] = entry.getModificationTime();
+
+    return result;
+}
+
+juce::Array<juce::File> PresetDirectoryWatcher::waitForChanges(int timeoutMs)
+{
+    juce::Thread::sleep(timeoutMs);
+
+    juce::Array<juce::File> changed;
+    auto current = takeSnapshot();
+
+    for (const auto& [path, modified] : current)
+    {
+        auto previous = snapshot.find(path);
+        if (previous == snapshot.end() || previous->second != modified)
+            changed.add(juce::File(path));
+    }
+
+    for (const auto& entry : snapshot)
+        if (current.find(entry.first) == current.end())
+            changed.add(juce::File(entry.first));
+
+    snapshot = std::move(current);
+    return changed;
+}
+
+#endif
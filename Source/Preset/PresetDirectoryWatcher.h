@@ -0,0 +1,35 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Reports preset files that were created, modified, renamed or deleted in one
+// directory. Uses inotify on Linux; other platforms fall back to comparing
+// modification times between calls.
+class PresetDirectoryWatcher
+{
+public:
+    explicit PresetDirectoryWatcher(const juce::File& directoryToWatch);
+    ~PresetDirectoryWatcher();
+
+    // Blocks for up to timeoutMs and returns the preset files that changed since the
+    // previous call. Deleted files are returned too; callers check existsAsFile().
+    juce::Array<juce::File> waitForChanges(int timeoutMs);
+
+private:
+    juce::File directory;
+
+#if JUCE_LINUX
+    int inotifyFd = -1;
+    int watchDescriptor = -1;
+
+    bool ensureWatching();
+#else
+    std::map<juce::String, juce::Time> snapshot;
+
+    std::map<juce::String, juce::Time> takeSnapshot() const;
+#endif
+
+    static bool isPresetFileName(const juce::String& fileName);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetDirectoryWatcher)
+};
@@ -0,0 +1,180 @@
+#include "PresetIOService.h"
+
+PresetIOService::PresetIOService(PresetIndex& indexToUpdate)
+    : juce::Thread("Preset I/O"), presetIndex(indexToUpdate)
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+PresetIOService::~PresetIOService()
+{
+    signalThreadShouldExit();
+    workAvailable.signal();
+    stopThread(10000);
+
+    // Anything the thread did not get to
+    writeSaves(false);
+}
+
+void PresetIOService::save(const juce::File& file, const PresetSerialization::Preset& preset, Completion onComplete)
+{
+    {
+        const juce::ScopedLock sl(queueLock);
+
+        auto& pending = pendingSaves[file.getFullPathName()];
+        pending.file = file;
+        pending.preset = preset;
+        pending.requestedMs = juce::Time::getMillisecondCounter();
+
+        if (onComplete != nullptr)
+            pending.callbacks.push_back(std::move(onComplete));
+    }
+
+    workAvailable.signal();
+}
+
+void PresetIOService::remove(const juce::Array<juce::File>& files, Completion onComplete)
+{
+    std::vector<Completion> superseded;
+
+    {
+        const juce::ScopedLock sl(queueLock);
+
+        for (const auto& file : files)
+        {
+            auto it = pendingSaves.find(file.getFullPathName());
+            if (it == pendingSaves.end())
+                continue;
+
+            for (auto& callback : it->second.callbacks)
+                superseded.push_back(std::move(callback));
+
+            pendingSaves.erase(it);
+        }
+    }
+
+    for (auto& callback : superseded)
+        complete(std::move(callback), false);
+
+    perform([this, files]
+    {
+        bool removed = true;
+
+        for (const auto& file : files)
+        {
+            // deleteFile() also succeeds when the file was never there
+            removed = file.deleteFile() && removed;
+            presetIndex.refreshFile(file);
+        }
+
+        return removed;
+    }, std::move(onComplete));
+}
+
+void PresetIOService::perform(std::function<bool()> work, Completion onComplete)
+{
+    {
+        const juce::ScopedLock sl(queueLock);
+        tasks.push_back({ std::move(work), std::move(onComplete) });
+    }
+
+    workAvailable.signal();
+}
+
+void PresetIOService::run()
+{
+    while (!threadShouldExit())
+    {
+        Task task;
+        bool haveTask = false;
+        bool haveSaves = false;
+
+        {
+            const juce::ScopedLock sl(queueLock);
+
+            if (!tasks.empty())
+            {
+                task = std::move(tasks.front());
+                tasks.pop_front();
+                haveTask = true;
+            }
+
+            haveSaves = !pendingSaves.empty();
+        }
+
+        if (haveTask)
+        {
+            // Earlier saves must land before anything that may read those files
+            writeSaves(false);
+
+            auto success = task.work != nullptr && task.work();
+            complete(std::move(task.onComplete), success);
+            continue;
+        }
+
+        if (haveSaves)
+        {
+            writeSaves(true);
+            workAvailable.wait(saveBatchDelayMs / 2);
+        }
+        else
+        {
+            workAvailable.wait(-1);
+        }
+    }
+}
+
+void PresetIOService::writeSaves(bool onlyIfSettled)
+{
+    std::vector<PendingSave> ready;
+
+    {
+        const juce::ScopedLock sl(queueLock);
+        auto now = juce::Time::getMillisecondCounter();
+
+        for (auto it = pendingSaves.begin(); it != pendingSaves.end();)
+        {
+            if (!onlyIfSettled || now - it->second.requestedMs >= static_cast<juce::uint32>(saveBatchDelayMs))
+            {
+                ready.push_back(std::move(it->second));
+                it = pendingSaves.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    for (auto& pending : ready)
+    {
+        auto directory = pending.file.getParentDirectory();
+        if (!directory.exists())
+            directory.createDirectory();
+
+        auto written = PresetSerialization::writeFile(pending.file, pending.preset);
+
+        if (written)
+            presetIndex.refreshFile(pending.file);
+        else
+            DBG("Failed to write preset: " + pending.file.getFullPathName());
+
+        for (auto& callback : pending.callbacks)
+            complete(std::move(callback), written);
+    }
+}
+
+void PresetIOService::complete(Completion onComplete, bool success)
+{
+    if (onComplete == nullptr)
+        return;
+
+    // Without a message loop (e.g. during shutdown) there is nowhere to post to
+    if (juce::MessageManager::getInstanceWithoutCreating() == nullptr)
+        return;
+
+    juce::MessageManager::callAsync([onComplete = std::move(onComplete), success]
+    {
+        onComplete(success);
+    });
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetIndex.h"
+#include "PresetSerialization.h"
+
+// Runs preset file I/O on a background thread so slow disks never stall the UI.
+//
+// Saves are batched: a save only hits the disk once no newer save to the same
+// file has arrived for saveBatchDelayMs, and only the last one is written. Every
+// other task first flushes pending saves, so work always sees the files in the
+// order it was requested. Writes refresh the preset index from this thread.
+//
+// Completion callbacks run on the message thread.
+class PresetIOService : private juce::Thread
+{
+public:
+    using Completion = std::function<void(bool success)>;
+
+    explicit PresetIOService(PresetIndex& indexToUpdate);
+
+    // Writes any saves still pending before returning
+    ~PresetIOService() override;
+
+    void save(const juce::File& file, const PresetSerialization::Preset& preset, Completion onComplete = nullptr);
+
+    // Cancels pending saves to the same files
+    void remove(const juce::Array<juce::File>& files, Completion onComplete = nullptr);
+
+    // Runs work on the I/O thread, then reports its result on the message thread
+    void perform(std::function<bool()> work, Completion onComplete = nullptr);
+
+private:
+    struct PendingSave
+    {
+        juce::File file;
+        PresetSerialization::Preset preset;
+        std::vector<Completion> callbacks;
+        juce::uint32 requestedMs = 0;
+    };
+
+    struct Task
+    {
+        std::function<bool()> work;
+        Completion onComplete;
+    };
+
+    static constexpr int saveBatchDelayMs = 150;
+
+    void run() override;
+    void writeSaves(bool onlyIfSettled);
+    static void complete(Completion onComplete, bool success);
+
+    PresetIndex& presetIndex;
+
+    juce::CriticalSection queueLock;
+    std::map<juce::String, PendingSave> pendingSaves; // by full path
+    std::deque<Task> tasks;
+    juce::WaitableEvent workAvailable;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIOService)
+};
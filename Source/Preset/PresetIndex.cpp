@@ -0,0 +1,177 @@
+#include "PresetIndex.h"
+#include "PresetSerialization.h"
+
+PresetIndex::PresetIndex(const juce::File& presetsDirectory)
+    : juce::Thread("Preset Index"), directory(presetsDirectory)
+{
+    startThread(juce::Thread::Priority::low);
+}
+
+PresetIndex::~PresetIndex()
+{
+    stopThread(4 * watchTimeoutMs);
+}
+
+juce::StringArray PresetIndex::getNames() const
+{
+    const juce::ScopedReadLock sl(lock);
+
+    juce::StringArray names;
+    for (const auto& [key, entry] : entries)
+        names.add(entry.name);
+
+    return names;
+}
+
+juce::StringArray PresetIndex::getNamesWithTag(const juce::String& tag) const
+{
+    const juce::ScopedReadLock sl(lock);
+
+    juce::StringArray names;
+    for (const auto& [key, entry] : entries)
+        if (entry.tags.contains(tag, true))
+            names.add(entry.name);
+
+    return names;
+}
+
+bool PresetIndex::contains(const juce::String& name) const
+{
+    const juce::ScopedReadLock sl(lock);
+    return entries.find(name) != entries.end();
+}
+
+juce::StringArray PresetIndex::search(const juce::String& query, int maxResults) const
+{
+    const juce::ScopedReadLock sl(lock);
+    return searchIndex.search(query, maxResults);
+}
+
+juce::StringArray PresetIndex::findSimilar(const juce::String& name, int maxResults) const
+{
+    const juce::ScopedReadLock sl(lock);
+    return searchIndex.findSimilar(name, maxResults);
+}
+
+bool PresetIndex::getState(const juce::String& name, juce::ValueTree& stateOut) const
+{
+    const juce::ScopedReadLock sl(lock);
+
+    auto it = entries.find(name);
+    if (it == entries.end() || !it->second.state.isValid())
+        return false;
+
+    stateOut = it->second.state.createCopy();
+    return true;
+}
+
+void PresetIndex::refreshFile(const juce::File& file)
+{
+    auto key = file.getFileNameWithoutExtension();
+
+    // A binary preset shadows a legacy one with the same name
+    auto binaryFile = file.withFileExtension(PresetSerialization::binaryExtension);
+    auto legacyFile = file.withFileExtension(PresetSerialization::legacyExtension);
+
+    Entry entry;
+    bool valid = (binaryFile.existsAsFile() && parsePresetFile(binaryFile, entry))
+        || (legacyFile.existsAsFile() && parsePresetFile(legacyFile, entry));
+
+    {
+        const juce::ScopedWriteLock sl(lock);
+
+        // Dropped first, so a preset whose embedded name changed is not found
+        // under the old one
+        searchIndex.remove(key);
+
+        if (valid)
+        {
+            addToSearch(key, entry);
+            entries[key] = std::move(entry);
+        }
+        else
+        {
+            entries.erase(key);
+        }
+    }
+
+    sendChangeMessage();
+}
+
+bool PresetIndex::parsePresetFile(const juce::File& file, Entry& entry)
+{
+    PresetSerialization::Preset preset;
+    if (!PresetSerialization::readFile(file, preset))
+        return false;
+
+    entry.name = preset.name;
+    entry.file = file;
+    entry.state = preset.state;
+    entry.tags = preset.tags;
+    entry.category = preset.category;
+    entry.author = preset.author;
+    entry.modified = file.getLastModificationTime();
+
+    return entry.state.isValid();
+}
+
+void PresetIndex::run()
+{
+    // Start watching before the scan so nothing written during it is missed
+    watcher = std::make_unique<PresetDirectoryWatcher>(directory);
+
+    scanAll();
+    ready = true;
+    sendChangeMessage();
+
+    while (!threadShouldExit())
+    {
+        for (const auto& file : watcher->waitForChanges(watchTimeoutMs))
+        {
+            if (threadShouldExit())
+                break;
+
+            refreshFile(file);
+        }
+    }
+}
+
+void PresetIndex::scanAll()
+{
+    std::map<juce::String, Entry> scanned;
+
+    if (directory.isDirectory())
+    {
+        for (const auto& dirEntry : juce::RangedDirectoryIterator(directory, false, "*.mpreset;*.preset", juce::File::findFiles))
+        {
+            if (threadShouldExit())
+                return;
+
+            Entry entry;
+            if (!parsePresetFile(dirEntry.getFile(), entry))
+                continue;
+
+            // Binary wins over a legacy file of the same name, whatever the scan order
+            auto key = dirEntry.getFile().getFileNameWithoutExtension();
+            auto existing = scanned.find(key);
+            if (existing == scanned.end() || !existing->second.file.hasFileExtension(PresetSerialization::binaryExtension))
+                scanned[key] = std::move(entry);
+        }
+    }
+
+    const juce::ScopedWriteLock sl(lock);
+
+    // Files refreshed while scanning are newer than what the scan read
+    for (auto& [key, entry] : scanned)
+    {
+        auto inserted = entries.emplace(key, std::move(entry));
+        if (inserted.second)
+            addToSearch(key, inserted.first->second);
+    }
+}
+
+void PresetIndex::addToSearch(const juce::String& key, const Entry& entry)
+{
+    searchIndex.add({ key, entry.name, entry.tags, entry.category, entry.author,
+                      PresetSearchIndex::makeFingerprint(entry.state) });
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetDirectoryWatcher.h"
+#include "PresetSearchIndex.h"
+
+// In-memory index of the user presets on disk: names, tags, files and the parsed
+// parameter state. Built once on a background thread, then kept up to date from
+// directory change notifications, so listing, filtering and loading presets never
+// touch the disk. Sends a change message whenever the contents change.
+class PresetIndex : public juce::ChangeBroadcaster,
+    private juce::Thread
+{
+public:
+    struct Entry
+    {
+        juce::String name;
+        juce::StringArray tags;
+        juce::String category;
+        juce::String author;
+        juce::File file;
+        juce::ValueTree state;
+        juce::Time modified;
+    };
+
+    explicit PresetIndex(const juce::File& presetsDirectory);
+    ~PresetIndex() override;
+
+    // True once the initial scan has finished
+    bool isReady() const { return ready.load(); }
+
+    juce::StringArray getNames() const;
+    juce::StringArray getNamesWithTag(const juce::String& tag) const;
+    bool contains(const juce::String& name) const;
+
+    // Fuzzy search over names and metadata, with "tag:", "category:" and
+    // "author:" filters, and nearest neighbours by parameter values. Both
+    // return preset file names, as getState() takes.
+    juce::StringArray search(const juce::String& query, int maxResults) const;
+    juce::StringArray findSimilar(const juce::String& name, int maxResults) const;
+
+    // Copies the parsed state of a preset; returns false if it is not indexed
+    bool getState(const juce::String& name, juce::ValueTree& stateOut) const;
+
+    // Re-reads a single file straight away (after our own save or delete)
+    void refreshFile(const juce::File& file);
+
+    // Parses a binary or legacy preset file; returns false if it is not a valid preset
+    static bool parsePresetFile(const juce::File& file, Entry& entry);
+
+private:
+    void run() override;
+    void scanAll();
+    void addToSearch(const juce::String& key, const Entry& entry);
+
+    juce::File directory;
+    std::unique_ptr<PresetDirectoryWatcher> watcher;
+
+    mutable juce::ReadWriteLock lock;
+    std::map<juce::String, Entry> entries; // sorted by file name
+    PresetSearchIndex searchIndex;
+    std::atomic<bool> ready{ false };
+
+    static constexpr int watchTimeoutMs = 500;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetIndex)
+};
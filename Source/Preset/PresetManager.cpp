@@ -1,137 +1,211 @@
 #include "PresetManager.h"
+#include "PresetSerialization.h"
+#include "FactoryPresets.h"
 
-PresetManager::PresetManager(juce::AudioProcessorValueTreeState& vts)
-    : valueTreeState(vts), currentPresetName("Default"), isModified(false)
+SharedPresetIndex::SharedPresetIndex()
+    : PresetIndex(PresetManager::getPresetsDirectory())
 {
-    initializeFactoryPresets();
+}
+
+PresetManager::PresetManager(juce::AudioProcessorValueTreeState& vts, PresetMorphEngine& morph)
+    : valueTreeState(vts), morphEngine(morph), currentPresetName("Default"), isModified(false)
+{
+    // The index scans the presets directory in the background and keeps watching
+    // it; the first instance creates it and the others share it
+    ioService = std::make_unique<PresetIOService>(*presetIndex);
 }
 
 PresetManager::~PresetManager()
 {
+    // Writes pending saves before this instance lets go of the index
+    ioService.reset();
 }
 
-void PresetManager::savePreset(const juce::String& presetName)
+void PresetManager::savePreset(const juce::String& presetName, const juce::StringArray& tags,
+    const juce::String& category, Completion onComplete)
 {
     if (presetName.isEmpty())
         return;
 
-    auto presetFile = getPresetFile(presetName);
-    auto presetDir = presetFile.getParentDirectory();
+    // Capturing the state is cheap; the write happens on the I/O thread
+    PresetSerialization::Preset preset{ presetName, tags, valueTreeState.copyState(), category, authorName };
+    currentPresetName = presetName;
+    isModified = false;
 
-    if (!presetDir.exists())
-        presetDir.createDirectory();
+    ioService->save(getPresetFile(presetName), preset,
+        [safeThis = juce::WeakReference<PresetManager>(this), presetName, onComplete](bool success)
+        {
+            if (success)
+                DBG("Preset saved: " + presetName);
+            else
+                DBG("Failed to save preset: " + presetName);
+
+            if (safeThis != nullptr && onComplete != nullptr)
+                onComplete(success);
+        });
+}
 
-    auto state = getStateAsVar();
+void PresetManager::loadPreset(const juce::String& presetName, Completion onComplete)
+{
+    morphToPreset(presetName, morphTimeSeconds, std::move(onComplete));
+}
 
-    juce::DynamicObject::Ptr presetObject = new juce::DynamicObject();
-    presetObject->setProperty("name", presetName);
-    presetObject->setProperty("version", "1.0");
-    presetObject->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(false));
-    presetObject->setProperty("state", state);
+void PresetManager::morphToPreset(const juce::String& presetName, double seconds, Completion onComplete)
+{
+    if (presetName.isEmpty())
+        return;
 
-    juce::var presetVar(presetObject.get());
-    juce::String jsonString = juce::JSON::toString(presetVar);
+    // Parsed and resolved to a snapshot off the message thread
+    auto values = std::make_shared<PresetSchema::Values>();
 
-    if (presetFile.replaceWithText(jsonString))
+    ioService->perform([this, presetName, values]
     {
-        currentPresetName = presetName;
-        isModified = false;
-        DBG("Preset saved: " + presetName);
-    }
-    else
+        juce::ValueTree state;
+        if (!getPresetState(presetName, state))
+            return false;
+
+        *values = morphEngine.makeSnapshot(state);
+        return true;
+    },
+    [safeThis = juce::WeakReference<PresetManager>(this), presetName, seconds, values, onComplete](bool success)
     {
-        DBG("Failed to save preset: " + presetName);
-    }
+        if (safeThis == nullptr)
+            return;
+
+        if (success)
+        {
+            safeThis->applyValues(*values, seconds);
+            safeThis->currentPresetName = presetName;
+            safeThis->isModified = false;
+            DBG("Preset loaded: " + presetName);
+        }
+
+        if (onComplete != nullptr)
+            onComplete(success);
+    });
 }
 
-void PresetManager::loadPreset(const juce::String& presetName)
+void PresetManager::setBlendPresets(const juce::StringArray& presetNames, Completion onComplete)
 {
-    if (presetName.isEmpty())
+    if (presetNames.isEmpty())
         return;
 
-    auto presetFile = getPresetFile(presetName);
+    auto corners = std::make_shared<std::array<PresetMorphEngine::Snapshot, PresetMorphEngine::numCorners>>();
 
-    if (!presetFile.exists())
+    ioService->perform([this, presetNames, corners]
     {
-        DBG("Preset file not found: " + presetName);
-        return;
-    }
+        int numResolved = 0;
 
-    auto jsonString = presetFile.loadFileAsString();
-    auto presetVar = juce::JSON::parse(jsonString);
-
-    if (presetVar.isObject())
-    {
-        auto* presetObject = presetVar.getDynamicObject();
-        if (presetObject != nullptr && presetObject->hasProperty("state"))
+        for (const auto& name : presetNames)
         {
-            auto state = presetObject->getProperty("state");
-            setStateFromVar(state);
-            currentPresetName = presetName;
-            isModified = false;
-            DBG("Preset loaded: " + presetName);
+            juce::ValueTree state;
+            if (numResolved < PresetMorphEngine::numCorners && getPresetState(name, state))
+                (*corners)[static_cast<size_t>(numResolved++)] = morphEngine.makeSnapshot(state);
         }
-    }
-    else
+
+        if (numResolved == 0)
+            return false;
+
+        for (int i = numResolved; i < PresetMorphEngine::numCorners; ++i)
+            (*corners)[static_cast<size_t>(i)] = (*corners)[static_cast<size_t>(i % numResolved)];
+
+        return true;
+    },
+    [safeThis = juce::WeakReference<PresetManager>(this), corners, onComplete](bool success)
     {
-        DBG("Invalid preset format: " + presetName);
-    }
+        if (safeThis == nullptr)
+            return;
+
+        success = success && safeThis->morphEngine.setCorners(*corners, safeThis->morphTimeSeconds);
+
+        if (onComplete != nullptr)
+            onComplete(success);
+    });
 }
 
-void PresetManager::deletePreset(const juce::String& presetName)
+void PresetManager::deletePreset(const juce::String& presetName, Completion onComplete)
 {
     if (presetName.isEmpty())
         return;
 
-    auto presetFile = getPresetFile(presetName);
-
-    if (presetFile.exists())
-    {
-        if (presetFile.deleteFile())
-        {
-            DBG("Preset deleted: " + presetName);
-        }
-        else
+    // Remove both, otherwise the legacy file would reappear in the list
+    ioService->remove({ getPresetFile(presetName), getLegacyPresetFile(presetName) },
+        [safeThis = juce::WeakReference<PresetManager>(this), presetName, onComplete](bool success)
         {
-            DBG("Failed to delete preset: " + presetName);
-        }
-    }
+            if (success)
+                DBG("Preset deleted: " + presetName);
+            else
+                DBG("Failed to delete preset: " + presetName);
+
+            if (safeThis != nullptr && onComplete != nullptr)
+                onComplete(success);
+        });
 }
 
 void PresetManager::loadFactoryPreset(int presetIndex)
 {
-    if (presetIndex >= 0 && presetIndex < static_cast<int>(factoryPresets.size()))
+    if (presetIndex >= 0 && presetIndex < FactoryPresets::numPresets)
     {
-        const auto& preset = factoryPresets[presetIndex];
-        setStateFromVar(preset.presetData);
-        currentPresetName = preset.name;
-        isModified = false;
-        DBG("Factory preset loaded: " + preset.name);
+        applySnapshot(FactoryPresets::presets[presetIndex].name,
+            FactoryPresets::values[static_cast<size_t>(presetIndex)], morphTimeSeconds);
+        DBG("Factory preset loaded: " + currentPresetName);
     }
 }
 
-void PresetManager::createFactoryPresets()
+void PresetManager::applySnapshot(const juce::String& presetName, const PresetSchema::Values& values, double seconds)
 {
-    // This method can be called to save current factory presets to disk
-    for (const auto& preset : factoryPresets)
+    applyValues(values, seconds);
+    currentPresetName = presetName;
+    isModified = false;
+}
+
+void PresetManager::loadBankSnapshots(BankCallback onLoaded)
+{
+    auto names = std::make_shared<juce::StringArray>(getPresetNames());
+    auto snapshots = std::make_shared<std::vector<PresetSchema::Values>>();
+    auto valid = std::make_shared<std::vector<bool>>();
+
+    ioService->perform([this, names, snapshots, valid]
     {
-        auto presetFile = getPresetFile(preset.name);
-        auto presetDir = presetFile.getParentDirectory();
+        snapshots->reserve(static_cast<size_t>(names->size()));
+        valid->reserve(static_cast<size_t>(names->size()));
+
+        for (int i = 0; i < names->size(); ++i)
+        {
+            if (i < FactoryPresets::numPresets)
+            {
+                snapshots->push_back(FactoryPresets::values[static_cast<size_t>(i)]);
+                valid->push_back(true);
+                continue;
+            }
+
+            // Unreadable presets keep their slot so program numbers stay stable
+            juce::ValueTree state;
+            bool readable = getPresetState(names->getReference(i), state);
+            snapshots->push_back(readable ? morphEngine.makeSnapshot(state) : PresetSchema::Values{});
+            valid->push_back(readable);
+        }
 
-        if (!presetDir.exists())
-            presetDir.createDirectory();
+        return true;
+    },
+    [safeThis = juce::WeakReference<PresetManager>(this), names, snapshots, valid, onLoaded](bool)
+    {
+        if (safeThis != nullptr && onLoaded != nullptr)
+            onLoaded(*names, *snapshots, *valid);
+    });
+}
 
-        juce::DynamicObject::Ptr presetObject = new juce::DynamicObject();
-        presetObject->setProperty("name", preset.name);
-        presetObject->setProperty("version", "1.0");
-        presetObject->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(false));
-        presetObject->setProperty("state", preset.presetData);
-        presetObject->setProperty("factory", true);
+void PresetManager::createFactoryPresets()
+{
+    // This method can be called to save current factory presets to disk
+    for (int i = 0; i < FactoryPresets::numPresets; ++i)
+    {
+        juce::String name(FactoryPresets::presets[i].name);
 
-        juce::var presetVar(presetObject.get());
-        juce::String jsonString = juce::JSON::toString(presetVar);
+        PresetSerialization::Preset preset{ name, { "Factory" },
+            PresetSerialization::makeState(FactoryPresets::values[static_cast<size_t>(i)]), "Factory" };
 
-        presetFile.replaceWithText(jsonString);
+        ioService->save(getPresetFile(name), preset);
     }
 }
 
@@ -140,28 +214,37 @@ juce::StringArray PresetManager::getPresetNames() const
     juce::StringArray presetNames;
 
     // Add factory presets
-    for (const auto& preset : factoryPresets)
+    for (const auto& preset : FactoryPresets::presets)
     {
         presetNames.add(preset.name);
     }
 
-    // Add user presets
-    auto presetsDir = getPresetsDirectory();
-    if (presetsDir.exists())
+    // Add user presets from the in-memory index
+    for (const auto& name : presetIndex->getNames())
     {
-        auto presetFiles = presetsDir.findChildFiles(juce::File::findFiles, false, "*.preset");
-        for (const auto& file : presetFiles)
-        {
-            auto name = file.getFileNameWithoutExtension();
-            if (!presetNames.contains(name))
-                presetNames.add(name);
-        }
+        if (!presetNames.contains(name))
+            presetNames.add(name);
     }
 
     return presetNames;
 }
 
-juce::File PresetManager::getPresetsDirectory() const
+juce::StringArray PresetManager::getPresetNamesWithTag(const juce::String& tag) const
+{
+    return presetIndex->getNamesWithTag(tag);
+}
+
+juce::StringArray PresetManager::searchPresets(const juce::String& query, int maxResults) const
+{
+    return presetIndex->search(query, maxResults);
+}
+
+juce::StringArray PresetManager::findSimilarPresets(const juce::String& presetName, int maxResults) const
+{
+    return presetIndex->findSimilar(presetName, maxResults);
+}
+
+juce::File PresetManager::getPresetsDirectory()
 {
     auto userAppData = juce::File::getSpecialLocation(juce::File::userApplicationDataDirectory);
     return userAppData.getChildFile("MechaMovementSoundGenerator").getChildFile("Presets");
@@ -169,180 +252,50 @@ juce::File PresetManager::getPresetsDirectory() const
 
 juce::File PresetManager::getPresetFile(const juce::String& presetName) const
 {
-    return getPresetsDirectory().getChildFile(presetName + ".preset");
+    return getPresetsDirectory().getChildFile(presetName + PresetSerialization::binaryExtension);
 }
 
-juce::var PresetManager::getStateAsVar() const
+juce::File PresetManager::getLegacyPresetFile(const juce::String& presetName) const
 {
-    auto state = valueTreeState.copyState();
-    return juce::var(state.createXml().get());
+    return getPresetsDirectory().getChildFile(presetName + PresetSerialization::legacyExtension);
 }
 
-void PresetManager::setStateFromVar(const juce::var& state)
+bool PresetManager::getPresetState(const juce::String& presetName, juce::ValueTree& stateOut) const
 {
-    if (state.isString())
-    {
-        auto xmlState = juce::XmlDocument::parse(state.toString());
-        if (xmlState != nullptr)
-        {
-            auto newState = juce::ValueTree::fromXml(*xmlState);
-            if (newState.isValid())
-            {
-                valueTreeState.replaceState(newState);
-            }
-        }
-    }
-}
+    // Runs on the I/O thread. Indexed presets are already parsed; only fall back
+    // to the file while the initial scan is still running
+    if (presetIndex->getState(presetName, stateOut))
+        return true;
 
-void PresetManager::initializeFactoryPresets()
-{
-    factoryPresets.clear();
+    auto presetFile = getPresetFile(presetName);
 
-    // Default preset
-    {
-        juce::DynamicObject::Ptr defaultState = new juce::DynamicObject();
-        defaultState->setProperty("hydraulicIntensity", 0.5f);
-        defaultState->setProperty("hydraulicFilter", 0.7f);
-        defaultState->setProperty("hydraulicGain", 0.6f);
-        defaultState->setProperty("hydraulicEnable", true);
-
-        defaultState->setProperty("servoFreq", 0.4f);
-        defaultState->setProperty("servoModDepth", 0.3f);
-        defaultState->setProperty("servoGain", 0.5f);
-        defaultState->setProperty("servoEnable", true);
-
-        defaultState->setProperty("metalResonance", 0.6f);
-        defaultState->setProperty("metalDecay", 0.5f);
-        defaultState->setProperty("metalGain", 0.7f);
-        defaultState->setProperty("metalEnable", true);
-
-        defaultState->setProperty("gearRoughness", 0.4f);
-        defaultState->setProperty("gearSpeed", 0.5f);
-        defaultState->setProperty("gearGain", 0.5f);
-        defaultState->setProperty("gearEnable", true);
-
-        defaultState->setProperty("sampleGain", 0.6f);
-        defaultState->setProperty("samplePitch", 0.5f);
-        defaultState->setProperty("sampleEnable", true);
-
-        defaultState->setProperty("masterGain", 0.7f);
-
-        defaultState->setProperty("macro1", 0.0f);
-        defaultState->setProperty("macro2", 0.0f);
-        defaultState->setProperty("macro3", 0.0f);
-        defaultState->setProperty("macro4", 0.0f);
-
-        factoryPresets.push_back({ "Default", juce::var(defaultState.get()) });
-    }
+    if (!presetFile.exists())
+        presetFile = getLegacyPresetFile(presetName);
 
-    // Heavy Mech preset
+    if (!presetFile.exists())
     {
-        juce::DynamicObject::Ptr heavyState = new juce::DynamicObject();
-        heavyState->setProperty("hydraulicIntensity", 0.8f);
-        heavyState->setProperty("hydraulicFilter", 0.3f);
-        heavyState->setProperty("hydraulicGain", 0.9f);
-        heavyState->setProperty("hydraulicEnable", true);
-
-        heavyState->setProperty("servoFreq", 0.2f);
-        heavyState->setProperty("servoModDepth", 0.6f);
-        heavyState->setProperty("servoGain", 0.8f);
-        heavyState->setProperty("servoEnable", true);
-
-        heavyState->setProperty("metalResonance", 0.9f);
-        heavyState->setProperty("metalDecay", 0.8f);
-        heavyState->setProperty("metalGain", 1.0f);
-        heavyState->setProperty("metalEnable", true);
-
-        heavyState->setProperty("gearRoughness", 0.8f);
-        heavyState->setProperty("gearSpeed", 0.3f);
-        heavyState->setProperty("gearGain", 0.9f);
-        heavyState->setProperty("gearEnable", true);
-
-        heavyState->setProperty("sampleGain", 0.9f);
-        heavyState->setProperty("samplePitch", 0.2f);
-        heavyState->setProperty("sampleEnable", true);
-
-        heavyState->setProperty("masterGain", 0.8f);
-
-        heavyState->setProperty("macro1", 0.8f);
-        heavyState->setProperty("macro2", 0.3f);
-        heavyState->setProperty("macro3", 0.9f);
-        heavyState->setProperty("macro4", 0.2f);
-
-        factoryPresets.push_back({ "Heavy Mech", juce::var(heavyState.get()) });
+        DBG("Preset file not found: " + presetName);
+        return false;
     }
 
-    // Light Scout preset
+    PresetIndex::Entry entry;
+    if (!PresetIndex::parsePresetFile(presetFile, entry))
     {
-        juce::DynamicObject::Ptr lightState = new juce::DynamicObject();
-        lightState->setProperty("hydraulicIntensity", 0.3f);
-        lightState->setProperty("hydraulicFilter", 0.9f);
-        lightState->setProperty("hydraulicGain", 0.4f);
-        lightState->setProperty("hydraulicEnable", true);
-
-        lightState->setProperty("servoFreq", 0.8f);
-        lightState->setProperty("servoModDepth", 0.2f);
-        lightState->setProperty("servoGain", 0.6f);
-        lightState->setProperty("servoEnable", true);
-
-        lightState->setProperty("metalResonance", 0.4f);
-        lightState->setProperty("metalDecay", 0.3f);
-        lightState->setProperty("metalGain", 0.5f);
-        lightState->setProperty("metalEnable", true);
-
-        lightState->setProperty("gearRoughness", 0.2f);
-        lightState->setProperty("gearSpeed", 0.8f);
-        lightState->setProperty("gearGain", 0.4f);
-        lightState->setProperty("gearEnable", true);
-
-        lightState->setProperty("sampleGain", 0.5f);
-        lightState->setProperty("samplePitch", 0.8f);
-        lightState->setProperty("sampleEnable", true);
-
-        lightState->setProperty("masterGain", 0.6f);
-
-        lightState->setProperty("macro1", 0.3f);
-        lightState->setProperty("macro2", 0.8f);
-        lightState->setProperty("macro3", 0.2f);
-        lightState->setProperty("macro4", 0.7f);
-
-        factoryPresets.push_back({ "Light Scout", juce::var(lightState.get()) });
+        DBG("Invalid preset format: " + presetName);
+        return false;
     }
 
-    // Battle Damaged preset
-    {
-        juce::DynamicObject::Ptr damagedState = new juce::DynamicObject();
-        damagedState->setProperty("hydraulicIntensity", 0.9f);
-        damagedState->setProperty("hydraulicFilter", 0.1f);
-        damagedState->setProperty("hydraulicGain", 0.8f);
-        damagedState->setProperty("hydraulicEnable", true);
-
-        damagedState->setProperty("servoFreq", 0.3f);
-        damagedState->setProperty("servoModDepth", 0.9f);
-        damagedState->setProperty("servoGain", 0.7f);
-        damagedState->setProperty("servoEnable", true);
-
-        damagedState->setProperty("metalResonance", 0.8f);
-        damagedState->setProperty("metalDecay", 0.9f);
-        damagedState->setProperty("metalGain", 0.9f);
-        damagedState->setProperty("metalEnable", true);
-
-        damagedState->setProperty("gearRoughness", 1.0f);
-        damagedState->setProperty("gearSpeed", 0.6f);
-        damagedState->setProperty("gearGain", 0.8f);
-        damagedState->setProperty("gearEnable", true);
-
-        damagedState->setProperty("sampleGain", 0.7f);
-        damagedState->setProperty("samplePitch", 0.4f);
-        damagedState->setProperty("sampleEnable", true);
-
-        damagedState->setProperty("masterGain", 0.9f);
-
-        damagedState->setProperty("macro1", 0.9f);
-        damagedState->setProperty("macro2", 0.1f);
-        damagedState->setProperty("macro3", 0.8f);
-        damagedState->setProperty("macro4", 0.6f);
-
-        factoryPresets.push_back({ "Battle Damaged", juce::var(damagedState.get()) });
-    }
-}
\ No newline at end of file
+    stateOut = entry.state;
+    return true;
+}
+
+void PresetManager::applyValues(const PresetSchema::Values& values, double seconds)
+{
+    // Even an instant change goes through the engine while audio is running, so
+    // it cannot be overwritten by a morph that is still in flight. Without a
+    // running audio callback a morph would never complete.
+    if (morphEngine.isAudioRunning() && morphEngine.morphTo(values, seconds))
+        return;
+
+    morphEngine.applyNow(values);
+}
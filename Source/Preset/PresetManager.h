@@ -1,50 +1,97 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "PresetIndex.h"
+#include "PresetMorphEngine.h"
+#include "PresetIOService.h"
+
+// The index of the user presets folder. Shared between plugin instances through
+// juce::SharedResourcePointer, so a session scans and watches the folder once.
+class SharedPresetIndex : public PresetIndex
+{
+public:
+    SharedPresetIndex();
+};
 
 class PresetManager
 {
 public:
-    PresetManager(juce::AudioProcessorValueTreeState& vts);
+    PresetManager(juce::AudioProcessorValueTreeState& vts, PresetMorphEngine& morph);
     ~PresetManager();
 
-    // Preset operations
-    void savePreset(const juce::String& presetName);
-    void loadPreset(const juce::String& presetName);
-    void deletePreset(const juce::String& presetName);
+    // Preset operations. File access happens on a background thread; the
+    // optional callbacks run on the message thread once it has finished.
+    using Completion = PresetIOService::Completion;
+
+    void savePreset(const juce::String& presetName, const juce::StringArray& tags = {},
+        const juce::String& category = {}, Completion onComplete = nullptr);
+    void loadPreset(const juce::String& presetName, Completion onComplete = nullptr);
+    void deletePreset(const juce::String& presetName, Completion onComplete = nullptr);
+
+    // Morphing. Loading a preset glides to it over the morph time while audio is
+    // running; the XY blend takes up to four presets, and missing corners repeat
+    // from the start of the list.
+    void setMorphTime(double seconds) { morphTimeSeconds = juce::jmax(0.0, seconds); }
+    double getMorphTime() const { return morphTimeSeconds; }
+    void morphToPreset(const juce::String& presetName, double seconds, Completion onComplete = nullptr);
+    void setBlendPresets(const juce::StringArray& presetNames, Completion onComplete = nullptr);
+    void setBlendPosition(float x, float y) { morphEngine.setPosition(x, y); }
 
     // Factory presets
     void loadFactoryPreset(int presetIndex);
     void createFactoryPresets();
 
+    // Applies an already resolved snapshot and makes it the current preset
+    void applySnapshot(const juce::String& presetName, const PresetSchema::Values& values, double seconds);
+
+    // Resolves every preset in getPresetNames() to a snapshot on the I/O thread;
+    // the callback runs on the message thread with the names and values in order.
+    // Unreadable presets keep their slot, marked false in valid, with no values.
+    using BankCallback = std::function<void(const juce::StringArray& names, const std::vector<PresetSchema::Values>& snapshots,
+                                            const std::vector<bool>& valid)>;
+    void loadBankSnapshots(BankCallback onLoaded);
+
     // Preset management
     juce::StringArray getPresetNames() const;
-    juce::File getPresetsDirectory() const;
+    juce::StringArray getPresetNamesWithTag(const juce::String& tag) const;
+
+    // Fuzzy search over user presets; see PresetIndex::search for the syntax
+    juce::StringArray searchPresets(const juce::String& query, int maxResults = 100) const;
+    juce::StringArray findSimilarPresets(const juce::String& presetName, int maxResults = 10) const;
+
+    // Stored with every preset saved from now on
+    void setAuthorName(const juce::String& name) { authorName = name; }
+    juce::String getAuthorName() const { return authorName; }
+    static juce::File getPresetsDirectory();
+
+    // Broadcasts a change message whenever the user preset list changes
+    PresetIndex& getPresetIndex() { return *presetIndex; }
 
     // Current preset info
     juce::String getCurrentPresetName() const { return currentPresetName; }
     bool isCurrentPresetModified() const { return isModified; }
     void setCurrentPresetModified(bool modified) { isModified = modified; }
 
+    // For presets applied elsewhere, e.g. a Program Change on the audio thread
+    void setCurrentPresetName(const juce::String& name) { currentPresetName = name; isModified = false; }
+
 private:
     juce::AudioProcessorValueTreeState& valueTreeState;
+    PresetMorphEngine& morphEngine;
+    double morphTimeSeconds = 0.25;
     juce::String currentPresetName;
     bool isModified;
+    juce::String authorName;
 
-    // Factory preset definitions
-    struct FactoryPreset
-    {
-        juce::String name;
-        juce::var presetData;
-    };
-
-    std::vector<FactoryPreset> factoryPresets;
+    juce::SharedResourcePointer<SharedPresetIndex> presetIndex;
+    std::unique_ptr<PresetIOService> ioService;
 
     // Helper methods
     juce::File getPresetFile(const juce::String& presetName) const;
-    juce::var getStateAsVar() const;
-    void setStateFromVar(const juce::var& state);
-    void initializeFactoryPresets();
+    juce::File getLegacyPresetFile(const juce::String& presetName) const;
+    bool getPresetState(const juce::String& presetName, juce::ValueTree& stateOut) const;
+    void applyValues(const PresetSchema::Values& values, double seconds);
 
+    JUCE_DECLARE_WEAK_REFERENCEABLE(PresetManager)
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetManager)
 };
\ No newline at end of file
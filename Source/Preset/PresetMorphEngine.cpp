@@ -0,0 +1,335 @@
+#include "PresetMorphEngine.h"
+
+PresetMorphEngine::PresetMorphEngine(juce::AudioProcessorValueTreeState& vts, bool commitToHost)
+    : valueTreeState(vts)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+    {
+        auto parameterId = PresetSchema::parameters[i].parameterId;
+        auto* parameter = valueTreeState.getParameter(parameterId);
+
+        // Every schema entry should exist in the layout
+        jassert(parameter != nullptr);
+
+        if (parameter == nullptr)
+            continue;
+
+        // The schema ranges are used to validate compile-time tables
+        jassert(juce::approximatelyEqual(parameter->getNormalisableRange().start, PresetSchema::parameters[i].minValue)
+            && juce::approximatelyEqual(parameter->getNormalisableRange().end, PresetSchema::parameters[i].maxValue));
+
+        parameters[i] = parameter;
+        rawValues[i] = valueTreeState.getRawParameterValue(parameterId);
+        discrete[i] = parameter->isDiscrete() || parameter->isBoolean();
+        settleThreshold[i] = parameter->getNormalisableRange().getRange().getLength() * 1.0e-4f;
+    }
+
+    if (commitToHost)
+        startTimerHz(commitTimerHz);
+}
+
+PresetMorphEngine::~PresetMorphEngine()
+{
+    stopTimer();
+}
+
+PresetMorphEngine::Snapshot PresetMorphEngine::captureCurrent() const
+{
+    Snapshot values{};
+    readCurrentValues(values);
+    return values;
+}
+
+PresetMorphEngine::Snapshot PresetMorphEngine::makeSnapshot(const juce::ValueTree& state) const
+{
+    auto values = captureCurrent();
+
+    for (const auto& child : state)
+    {
+        auto index = PresetSchema::indexOf(child["id"].toString());
+        if (index < 0 || parameters[index] == nullptr)
+            continue;
+
+        auto value = static_cast<float>(child["value"]);
+        values[index] = parameters[index]->getNormalisableRange().snapToLegalValue(value);
+    }
+
+    return values;
+}
+
+bool PresetMorphEngine::morphTo(const Snapshot& target, double seconds)
+{
+    Request request;
+    request.mode = Mode::transition;
+    request.snapshots[0] = target;
+    request.seconds = seconds;
+
+    return pushRequest(request);
+}
+
+bool PresetMorphEngine::setCorners(const std::array<Snapshot, numCorners>& newCorners, double seconds)
+{
+    Request request;
+    request.mode = Mode::blend;
+    request.snapshots = newCorners;
+    request.seconds = seconds;
+
+    return pushRequest(request);
+}
+
+bool PresetMorphEngine::stop()
+{
+    return pushRequest(Request());
+}
+
+void PresetMorphEngine::applyNow(const Snapshot& values)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        if (auto* parameter = parameters[i])
+            parameter->setValueNotifyingHost(parameter->convertTo0to1(values[i]));
+}
+
+void PresetMorphEngine::setPosition(float x, float y)
+{
+    positionX.store(juce::jlimit(0.0f, 1.0f, x));
+    positionY.store(juce::jlimit(0.0f, 1.0f, y));
+}
+
+bool PresetMorphEngine::isAudioRunning() const
+{
+    constexpr juce::uint32 stoppedAfterMs = 250;
+    return juce::Time::getMillisecondCounter() - lastProcessMs.load() < stoppedAfterMs;
+}
+
+bool PresetMorphEngine::pushRequest(const Request& request)
+{
+    int start1, size1, start2, size2;
+    requestFifo.prepareToWrite(1, start1, size1, start2, size2);
+
+    if (size1 + size2 == 0)
+        return false;
+
+    requests[static_cast<size_t>(size1 > 0 ? start1 : start2)] = request;
+    requestFifo.finishedWrite(1);
+
+    // Reported straight away so the UI does not see a gap before the next block
+    if (request.mode != Mode::idle)
+        morphing.store(true);
+
+    return true;
+}
+
+void PresetMorphEngine::prepare(double sampleRate, int samplesPerBlock)
+{
+    juce::ignoreUnused(samplesPerBlock);
+    currentSampleRate = sampleRate;
+}
+
+void PresetMorphEngine::process(int numSamples)
+{
+    lastProcessMs.store(juce::Time::getMillisecondCounter());
+
+    // Only the newest request matters; older ones were superseded before they ran
+    while (requestFifo.getNumReady() > 0)
+    {
+        int start1, size1, start2, size2;
+        requestFifo.prepareToRead(1, start1, size1, start2, size2);
+        handleRequest(requests[static_cast<size_t>(size1 > 0 ? start1 : start2)]);
+        requestFifo.finishedRead(1);
+    }
+
+    // A previous commit was still being applied when this one finished
+    if (commitWaiting && !commitPending.load(std::memory_order_acquire))
+        finishMorph();
+
+    if (mode == Mode::transition)
+    {
+        auto durationSamples = morphSeconds * currentSampleRate;
+        progress = durationSamples > 0.0 ? progress + numSamples / durationSamples : 1.0;
+
+        auto t = static_cast<float>(juce::jmin(progress, 1.0));
+        auto eased = t * t * (3.0f - 2.0f * t);
+
+        for (int i = 0; i < PresetSchema::numParameters; ++i)
+        {
+            if (discrete[i])
+                currentValues[i] = t < 0.5f ? startValues[i] : targetValues[i];
+            else
+                currentValues[i] = startValues[i] + (targetValues[i] - startValues[i]) * eased;
+        }
+
+        writeValues(currentValues);
+
+        if (progress >= 1.0)
+        {
+            mode = Mode::idle;
+            finishMorph();
+        }
+    }
+    else if (mode == Mode::blend)
+    {
+        auto x = positionX.load();
+        auto y = positionY.load();
+
+        if (x != lastX || y != lastY)
+        {
+            // Resume from wherever the parameters are now, the user may have edited them
+            if (blendSettled)
+            {
+                readCurrentValues(currentValues);
+                blendSettled = false;
+                commitWaiting = false;
+                morphing.store(true);
+            }
+
+            computeBlendTarget(x, y);
+            lastX = x;
+            lastY = y;
+        }
+
+        if (blendSettled)
+            return;
+
+        auto durationSamples = morphSeconds * currentSampleRate;
+        auto coefficient = durationSamples > 0.0
+            ? static_cast<float>(1.0 - std::exp(-numSamples / durationSamples))
+            : 1.0f;
+
+        bool settled = true;
+
+        for (int i = 0; i < PresetSchema::numParameters; ++i)
+        {
+            if (discrete[i])
+                currentValues[i] = targetValues[i];
+            else
+                currentValues[i] += (targetValues[i] - currentValues[i]) * coefficient;
+
+            if (std::abs(targetValues[i] - currentValues[i]) > settleThreshold[i])
+                settled = false;
+        }
+
+        if (settled)
+            currentValues = targetValues;
+
+        writeValues(currentValues);
+
+        if (settled)
+        {
+            // Stop writing until the position moves so parameter edits stick
+            blendSettled = true;
+            finishMorph();
+        }
+    }
+}
+
+void PresetMorphEngine::jumpTo(const Snapshot& values)
+{
+    mode = Mode::idle;
+    commitWaiting = false;
+    currentValues = values;
+    writeValues(currentValues);
+    finishMorph();
+}
+
+void PresetMorphEngine::handleRequest(const Request& request)
+{
+    commitWaiting = false;
+    morphSeconds = juce::jmax(0.0, request.seconds);
+
+    switch (request.mode)
+    {
+    case Mode::idle:
+        if (mode == Mode::transition || (mode == Mode::blend && !blendSettled))
+            finishMorph();
+
+        mode = Mode::idle;
+        morphing.store(false);
+        break;
+
+    case Mode::transition:
+        readCurrentValues(startValues);
+        currentValues = startValues;
+        targetValues = request.snapshots[0];
+        progress = 0.0;
+        mode = Mode::transition;
+        morphing.store(true);
+        break;
+
+    case Mode::blend:
+        corners = request.snapshots;
+        readCurrentValues(currentValues);
+        lastX = -1.0f;
+        lastY = -1.0f;
+        blendSettled = false;
+        mode = Mode::blend;
+        morphing.store(true);
+        break;
+    }
+}
+
+void PresetMorphEngine::readCurrentValues(Snapshot& values) const
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        values[i] = rawValues[i] != nullptr ? rawValues[i]->load() : 0.0f;
+}
+
+void PresetMorphEngine::writeValues(const Snapshot& values)
+{
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        if (rawValues[i] != nullptr)
+            rawValues[i]->store(values[i]);
+}
+
+void PresetMorphEngine::computeBlendTarget(float x, float y)
+{
+    const std::array<float, numCorners> weights{
+        (1.0f - x) * (1.0f - y),
+        x * (1.0f - y),
+        (1.0f - x) * y,
+        x * y
+    };
+
+    auto heaviest = static_cast<size_t>(std::distance(weights.begin(), std::max_element(weights.begin(), weights.end())));
+
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+    {
+        if (discrete[i])
+        {
+            targetValues[i] = corners[heaviest][i];
+            continue;
+        }
+
+        float value = 0.0f;
+        for (size_t c = 0; c < numCorners; ++c)
+            value += corners[c][i] * weights[c];
+
+        targetValues[i] = value;
+    }
+}
+
+void PresetMorphEngine::finishMorph()
+{
+    morphing.store(false);
+
+    if (commitPending.load(std::memory_order_acquire))
+    {
+        commitWaiting = true;
+        return;
+    }
+
+    committedValues = currentValues;
+    commitWaiting = false;
+    commitPending.store(true, std::memory_order_release);
+}
+
+void PresetMorphEngine::timerCallback()
+{
+    if (!commitPending.load(std::memory_order_acquire))
+        return;
+
+    // Parameters already hold these values, so this only brings the host and
+    // the listeners up to date
+    applyNow(committedValues);
+
+    commitPending.store(false, std::memory_order_release);
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetSchema.h"
+
+// Morphs parameter values between presets on the audio thread.
+//
+// Presets are resolved on the message thread into flat snapshots of plain
+// parameter values in PresetSchema order. The audio thread interpolates between
+// snapshots and writes the result straight into the APVTS raw values that the
+// generators read, so nothing on the audio path touches a ValueTree or notifies
+// listeners. Once a morph settles the final values are handed back to the message
+// thread, which updates the host in one go.
+//
+// Two modes:
+//   morphTo     - glide from the current values to one snapshot over a set time
+//   setCorners  - blend four snapshots from an XY position (bilinear; corners are
+//                 x0y0, x1y0, x0y1, x1y1), following XY moves with the same time
+//
+// Values are updated once per block; the generators' own smoothing removes the steps.
+// Discrete parameters (switches, choices) flip half way through a morph, or follow
+// the heaviest corner when blending.
+class PresetMorphEngine : private juce::Timer
+{
+public:
+    using Snapshot = PresetSchema::Values;
+    static constexpr int numCorners = 4;
+
+    // Without commitToHost, settled values are never handed back to the message
+    // thread; for offline renders, where it does not run
+    explicit PresetMorphEngine(juce::AudioProcessorValueTreeState& vts, bool commitToHost = true);
+    ~PresetMorphEngine() override;
+
+    // Message thread: build snapshots. Parameters missing from the state keep
+    // their current value.
+    Snapshot captureCurrent() const;
+    Snapshot makeSnapshot(const juce::ValueTree& state) const;
+
+    // Message thread: start a morph. Returns false if the request queue is full.
+    bool morphTo(const Snapshot& target, double seconds);
+    bool setCorners(const std::array<Snapshot, numCorners>& corners, double seconds);
+    bool stop();
+
+    // Message thread: set the values immediately through the host, for when the
+    // audio is not running
+    void applyNow(const Snapshot& values);
+
+    // Any thread; both coordinates are 0-1
+    void setPosition(float x, float y);
+    juce::Point<float> getPosition() const { return { positionX.load(), positionY.load() }; }
+
+    bool isMorphing() const { return morphing.load(); }
+
+    // True while process() is being called; when the audio is stopped a morph
+    // would never finish, so callers should apply state directly instead
+    bool isAudioRunning() const;
+
+    // Audio thread
+    void prepare(double sampleRate, int samplesPerBlock);
+    void process(int numSamples);
+
+    // Audio thread: switch to the values straight away, cancelling any morph;
+    // the host is updated afterwards like at the end of a morph
+    void jumpTo(const Snapshot& values);
+
+private:
+    enum class Mode
+    {
+        idle,
+        transition,
+        blend
+    };
+
+    struct Request
+    {
+        Mode mode = Mode::idle;
+        std::array<Snapshot, numCorners> snapshots{};
+        double seconds = 0.0;
+    };
+
+    static constexpr int requestQueueSize = 8;
+    static constexpr int commitTimerHz = 30;
+
+    bool pushRequest(const Request& request);
+    void handleRequest(const Request& request);
+
+    void readCurrentValues(Snapshot& values) const;
+    void writeValues(const Snapshot& values);
+    void computeBlendTarget(float x, float y);
+    void finishMorph();
+
+    void timerCallback() override;
+
+    juce::AudioProcessorValueTreeState& valueTreeState;
+
+    // Resolved once; indexed in schema order
+    std::array<juce::RangedAudioParameter*, PresetSchema::numParameters> parameters{};
+    std::array<std::atomic<float>*, PresetSchema::numParameters> rawValues{};
+    std::array<bool, PresetSchema::numParameters> discrete{};
+    std::array<float, PresetSchema::numParameters> settleThreshold{};
+
+    // Message thread -> audio thread
+    juce::AbstractFifo requestFifo{ requestQueueSize };
+    std::array<Request, requestQueueSize> requests;
+    std::atomic<float> positionX{ 0.0f };
+    std::atomic<float> positionY{ 0.0f };
+
+    // Audio thread state
+    double currentSampleRate = 44100.0;
+    Mode mode = Mode::idle;
+    Snapshot startValues{};
+    Snapshot targetValues{};
+    Snapshot currentValues{};
+    std::array<Snapshot, numCorners> corners{};
+    double morphSeconds = 0.0;
+    double progress = 0.0;
+    float lastX = -1.0f;
+    float lastY = -1.0f;
+    bool blendSettled = false;
+    bool commitWaiting = false;
+
+    // Audio thread -> message thread. The audio thread only writes committedValues
+    // while commitPending is false; the timer only reads them while it is true.
+    Snapshot committedValues{};
+    std::atomic<bool> commitPending{ false };
+    std::atomic<bool> morphing{ false };
+    std::atomic<juce::uint32> lastProcessMs{ 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PresetMorphEngine)
+};
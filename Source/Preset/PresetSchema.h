@@ -0,0 +1,173 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Stable description of the plugin's parameters for preset storage.
+// Binary presets key values by the numeric IDs below, never by position or name,
+// so parameters can be renamed or reordered without breaking saved presets.
+// Never reuse a numeric ID; retire it and add a new one instead.
+struct PresetSchema
+{
+    // 2: category and author strings after the tags
+    static constexpr int version = 2;
+    static constexpr const char* stateType = "Parameters";
+
+    struct Parameter
+    {
+        juce::uint16 stableId;
+        const char* parameterId;
+        float minValue;
+        float maxValue;
+    };
+
+    // In parameter layout order, with the plain value range from the layout.
+    // PresetMorphEngine checks the ranges against the real layout in debug builds.
+    static constexpr Parameter parameters[] = {
+        { 1,  "MASTER_GAIN",           0.0f, 2.0f },
+        { 2,  "MASTER_MIX",            0.0f, 1.0f },
+        { 3,  "HYDRAULIC_GAIN",        0.0f, 1.0f },
+        { 4,  "HYDRAULIC_PRESSURE",    0.1f, 10.0f },
+        { 5,  "HYDRAULIC_FLOW",        0.1f, 5.0f },
+        { 6,  "HYDRAULIC_ENABLE",      0.0f, 1.0f },
+        { 7,  "SERVO_GAIN",            0.0f, 1.0f },
+        { 8,  "SERVO_SPEED",           1.0f, 100.0f },
+        { 9,  "SERVO_WHINE",           0.0f, 1.0f },
+        { 10, "SERVO_ENABLE",          0.0f, 1.0f },
+        { 11, "METAL_GAIN",            0.0f, 1.0f },
+        { 12, "METAL_RESONANCE",       0.1f, 10.0f },
+        { 13, "METAL_DECAY",           0.1f, 5.0f },
+        { 14, "METAL_ENABLE",          0.0f, 1.0f },
+        { 15, "GEAR_GAIN",             0.0f, 1.0f },
+        { 16, "GEAR_ROUGHNESS",        0.1f, 2.0f },
+        { 17, "GEAR_SPEED",            0.1f, 10.0f },
+        { 18, "GEAR_ENABLE",           0.0f, 1.0f },
+        { 19, "SAMPLE_GAIN",           0.0f, 1.0f },
+        { 20, "SAMPLE_PITCH",          0.25f, 4.0f },
+        { 21, "SAMPLE_ENABLE",         0.0f, 1.0f },
+        { 22, "SAMPLE_MODE",           0.0f, 1.0f },
+        { 23, "SAMPLE_GRAIN_DENSITY",  1.0f, 400.0f },
+        { 24, "SAMPLE_GRAIN_SIZE",     5.0f, 500.0f },
+        { 25, "SAMPLE_GRAIN_POSITION", 0.0f, 1.0f },
+        { 26, "SAMPLE_GRAIN_JITTER",   0.0f, 1.0f },
+        { 27, "SAMPLE_GRAIN_SPRAY",    0.0f, 12.0f },
+        { 28, "MACRO_1",               0.0f, 1.0f },
+        { 29, "MACRO_2",               0.0f, 1.0f },
+        { 30, "MACRO_3",               0.0f, 1.0f },
+        { 31, "MACRO_4",               0.0f, 1.0f },
+    };
+
+    static constexpr int numParameters = static_cast<int>(std::size(parameters));
+
+    // Plain parameter values in table order
+    using Values = std::array<float, numParameters>;
+
+    // Numeric IDs replaced in a later schema version. Presets older than
+    // untilVersion have oldId read as newId; newId == 0 means the value is dropped.
+    struct StableIdMigration
+    {
+        int untilVersion;
+        juce::uint16 oldId;
+        juce::uint16 newId;
+    };
+
+    static constexpr std::array<StableIdMigration, 0> stableIdMigrations{};
+
+    // Parameter names used by legacy JSON presets and the early camelCase layout.
+    // A null newId marks a parameter that no longer exists.
+    struct NameMigration
+    {
+        const char* oldId;
+        const char* newId;
+    };
+
+    static constexpr NameMigration nameMigrations[] = {
+        { "masterGain",         "MASTER_GAIN" },
+        { "masterMix",          "MASTER_MIX" },
+        { "hydraulicGain",      "HYDRAULIC_GAIN" },
+        { "hydraulicPressure",  "HYDRAULIC_PRESSURE" },
+        { "hydraulicEnable",    "HYDRAULIC_ENABLE" },
+        { "hydraulicHiss",      nullptr },
+        { "hydraulicRelease",   nullptr },
+        { "hydraulicIntensity", nullptr },
+        { "hydraulicFilter",    nullptr },
+        { "servoGain",          "SERVO_GAIN" },
+        { "servoSpeed",         "SERVO_SPEED" },
+        { "servoEnable",        "SERVO_ENABLE" },
+        { "servoWhine",         nullptr },  // was a frequency in Hz, now a 0-1 amount
+        { "servoTension",       nullptr },
+        { "servoFreq",          nullptr },
+        { "servoModDepth",      nullptr },
+        { "metalGain",          "METAL_GAIN" },
+        { "metalResonance",     "METAL_RESONANCE" },
+        { "metalDecay",         "METAL_DECAY" },
+        { "metalEnable",        "METAL_ENABLE" },
+        { "metalBrightness",    nullptr },
+        { "gearGain",           "GEAR_GAIN" },
+        { "gearRoughness",      "GEAR_ROUGHNESS" },
+        { "gearSpeed",          "GEAR_SPEED" },
+        { "gearEnable",         "GEAR_ENABLE" },
+        { "gearTorque",         nullptr },
+        { "sampleGain",         "SAMPLE_GAIN" },
+        { "sampleEnable",       "SAMPLE_ENABLE" },
+        { "samplePitch",        nullptr },  // was semitones, now a playback ratio
+    };
+
+    // Usable in constant expressions, for tables validated at compile time
+    static constexpr bool idsMatch(const char* a, const char* b)
+    {
+        if (a == nullptr || b == nullptr)
+            return a == b;
+
+        for (; *a != 0 && *a == *b; ++a, ++b) {}
+
+        return *a == *b;
+    }
+
+    // Lookups; return 0 / nullptr when unknown
+    static juce::uint16 stableIdFor(const juce::String& parameterId)
+    {
+        for (const auto& p : parameters)
+            if (parameterId == p.parameterId)
+                return p.stableId;
+
+        return 0;
+    }
+
+    // Position in the parameters table, or -1
+    static int indexOf(const juce::String& parameterId)
+    {
+        for (int i = 0; i < numParameters; ++i)
+            if (parameterId == parameters[i].parameterId)
+                return i;
+
+        return -1;
+    }
+
+    static const char* parameterIdFor(juce::uint16 stableId)
+    {
+        for (const auto& p : parameters)
+            if (p.stableId == stableId)
+                return p.parameterId;
+
+        return nullptr;
+    }
+
+    // Maps an old parameter name to the current one; empty if it was retired
+    static juce::String migrateParameterId(const juce::String& parameterId)
+    {
+        for (const auto& m : nameMigrations)
+            if (parameterId == m.oldId)
+                return m.newId != nullptr ? juce::String(m.newId) : juce::String();
+
+        return parameterId;
+    }
+
+    static juce::uint16 migrateStableId(juce::uint16 stableId, int presetVersion)
+    {
+        for (const auto& m : stableIdMigrations)
+            if (presetVersion < m.untilVersion && m.oldId == stableId)
+                stableId = m.newId;
+
+        return stableId;
+    }
+};
@@ -0,0 +1,320 @@
+#include "PresetSearchIndex.h"
+
+namespace
+{
+    constexpr float minTrigramOverlap = 0.4f;
+
+    void removeFromPosting(std::vector<int>& posting, int slot)
+    {
+        auto it = std::find(posting.begin(), posting.end(), slot);
+        if (it != posting.end())
+        {
+            *it = posting.back();
+            posting.pop_back();
+        }
+    }
+}
+
+void PresetSearchIndex::add(const Document& document)
+{
+    remove(document.key);
+
+    int slotIndex;
+    if (!freeSlots.empty())
+    {
+        slotIndex = freeSlots.back();
+        freeSlots.pop_back();
+    }
+    else
+    {
+        slotIndex = static_cast<int>(slots.size());
+        slots.emplace_back();
+        fingerprints.resize(slots.size() * PresetSchema::numParameters);
+    }
+
+    auto& slot = slots[static_cast<size_t>(slotIndex)];
+    slot.key = document.key;
+    slot.name = document.name;
+    slot.lowerName = document.name.toLowerCase();
+    slot.alive = true;
+
+    slot.trigrams = trigramsForText(document.name + " " + document.tags.joinIntoString(" ")
+        + " " + document.category + " " + document.author);
+
+    for (auto trigram : slot.trigrams)
+        trigramPostings[trigram].push_back(slotIndex);
+
+    slot.terms.clearQuick();
+    for (const auto& tag : document.tags)
+        slot.terms.addIfNotAlreadyThere(fieldTerm("tag", tag));
+
+    if (document.category.isNotEmpty())
+        slot.terms.add(fieldTerm("category", document.category));
+
+    if (document.author.isNotEmpty())
+        slot.terms.add(fieldTerm("author", document.author));
+
+    for (const auto& term : slot.terms)
+        termPostings[term].push_back(slotIndex);
+
+    std::copy(document.fingerprint.begin(), document.fingerprint.end(),
+        fingerprints.begin() + static_cast<std::ptrdiff_t>(slotIndex) * PresetSchema::numParameters);
+
+    keyToDocument[document.key] = slotIndex;
+}
+
+void PresetSearchIndex::remove(const juce::String& key)
+{
+    auto found = keyToDocument.find(key);
+    if (found == keyToDocument.end())
+        return;
+
+    auto slotIndex = found->second;
+    auto& slot = slots[static_cast<size_t>(slotIndex)];
+
+    for (auto trigram : slot.trigrams)
+    {
+        auto posting = trigramPostings.find(trigram);
+        if (posting == trigramPostings.end())
+            continue;
+
+        removeFromPosting(posting->second, slotIndex);
+        if (posting->second.empty())
+            trigramPostings.erase(posting);
+    }
+
+    for (const auto& term : slot.terms)
+    {
+        auto posting = termPostings.find(term);
+        if (posting == termPostings.end())
+            continue;
+
+        removeFromPosting(posting->second, slotIndex);
+        if (posting->second.empty())
+            termPostings.erase(posting);
+    }
+
+    slot = Slot();
+    freeSlots.push_back(slotIndex);
+    keyToDocument.erase(found);
+}
+
+void PresetSearchIndex::clear()
+{
+    slots.clear();
+    freeSlots.clear();
+    keyToDocument.clear();
+    fingerprints.clear();
+    trigramPostings.clear();
+    termPostings.clear();
+}
+
+juce::StringArray PresetSearchIndex::search(const juce::String& query, int maxResults) const
+{
+    auto lowerQuery = query.toLowerCase();
+    auto tokens = juce::StringArray::fromTokens(lowerQuery, " \t", "");
+    tokens.removeEmptyStrings();
+
+    // Field filters narrow the candidates; everything else is free text
+    std::vector<char> allowed;
+    bool filtered = false;
+    juce::StringArray words;
+
+    for (const auto& token : tokens)
+    {
+        auto field = token.upToFirstOccurrenceOf(":", false, false);
+        auto value = token.fromFirstOccurrenceOf(":", false, false);
+
+        if (value.isEmpty() || (field != "tag" && field != "category" && field != "author"))
+        {
+            words.add(token);
+            continue;
+        }
+
+        std::vector<char> matching(slots.size(), 0);
+        auto posting = termPostings.find(fieldTerm(field, value));
+
+        if (posting != termPostings.end())
+            for (auto slotIndex : posting->second)
+                if (!filtered || allowed[static_cast<size_t>(slotIndex)] != 0)
+                    matching[static_cast<size_t>(slotIndex)] = 1;
+
+        allowed = std::move(matching);
+        filtered = true;
+    }
+
+    // The last word may still be being typed, so it only has to match a prefix
+    std::vector<Trigram> queryTrigrams;
+    bool lastWordIsPrefix = !query.endsWithChar(' ');
+
+    for (int i = 0; i < words.size(); ++i)
+        addTrigrams(words[i], lastWordIsPrefix && i == words.size() - 1, queryTrigrams);
+
+    std::sort(queryTrigrams.begin(), queryTrigrams.end());
+    queryTrigrams.erase(std::unique(queryTrigrams.begin(), queryTrigrams.end()), queryTrigrams.end());
+
+    std::vector<std::pair<float, int>> matches;
+
+    if (queryTrigrams.empty())
+    {
+        for (size_t s = 0; s < slots.size(); ++s)
+            if (slots[s].alive && (!filtered || allowed[s] != 0))
+                matches.emplace_back(0.0f, static_cast<int>(s));
+    }
+    else
+    {
+        std::vector<juce::uint16> shared(slots.size(), 0);
+
+        for (auto trigram : queryTrigrams)
+        {
+            auto posting = trigramPostings.find(trigram);
+            if (posting != trigramPostings.end())
+                for (auto slotIndex : posting->second)
+                    ++shared[static_cast<size_t>(slotIndex)];
+        }
+
+        auto numQueryTrigrams = static_cast<float>(queryTrigrams.size());
+        auto minShared = juce::jmax(1, static_cast<int>(std::ceil(numQueryTrigrams * minTrigramOverlap)));
+        auto phrase = words.joinIntoString(" ");
+
+        for (size_t s = 0; s < slots.size(); ++s)
+        {
+            if (shared[s] < minShared || (filtered && allowed[s] == 0))
+                continue;
+
+            // Name matches outrank tag and metadata matches
+            auto score = shared[s] / numQueryTrigrams;
+            if (slots[s].lowerName.startsWith(phrase))
+                score += 1.0f;
+            else if (slots[s].lowerName.contains(phrase))
+                score += 0.5f;
+
+            matches.emplace_back(score, static_cast<int>(s));
+        }
+    }
+
+    auto numResults = juce::jmin(static_cast<size_t>(juce::jmax(0, maxResults)), matches.size());
+
+    std::partial_sort(matches.begin(), matches.begin() + static_cast<std::ptrdiff_t>(numResults), matches.end(),
+        [this](const auto& a, const auto& b)
+        {
+            if (a.first != b.first)
+                return a.first > b.first;
+
+            return slots[static_cast<size_t>(a.second)].name.compareNatural(slots[static_cast<size_t>(b.second)].name) < 0;
+        });
+
+    juce::StringArray results;
+    for (size_t i = 0; i < numResults; ++i)
+        results.add(slots[static_cast<size_t>(matches[i].second)].key);
+
+    return results;
+}
+
+juce::StringArray PresetSearchIndex::findSimilar(const juce::String& key, int maxResults) const
+{
+    auto found = keyToDocument.find(key);
+    if (found == keyToDocument.end())
+        return {};
+
+    auto offset = static_cast<size_t>(found->second) * PresetSchema::numParameters;
+    return findSimilar(fingerprints.data() + offset, maxResults, found->second);
+}
+
+juce::StringArray PresetSearchIndex::findSimilar(const PresetSchema::Values& fingerprint, int maxResults) const
+{
+    return findSimilar(fingerprint.data(), maxResults, -1);
+}
+
+juce::StringArray PresetSearchIndex::findSimilar(const float* fingerprint, int maxResults, int excludeSlot) const
+{
+    // Exhaustive search; at 10k presets this is a few hundred thousand multiply-adds
+    std::vector<std::pair<float, int>> distances;
+    distances.reserve(keyToDocument.size());
+
+    for (size_t s = 0; s < slots.size(); ++s)
+    {
+        if (!slots[s].alive || static_cast<int>(s) == excludeSlot)
+            continue;
+
+        const auto* other = fingerprints.data() + s * PresetSchema::numParameters;
+        float distance = 0.0f;
+
+        for (int i = 0; i < PresetSchema::numParameters; ++i)
+        {
+            auto delta = fingerprint[i] - other[i];
+            distance += delta * delta;
+        }
+
+        distances.emplace_back(distance, static_cast<int>(s));
+    }
+
+    auto numResults = juce::jmin(static_cast<size_t>(juce::jmax(0, maxResults)), distances.size());
+    std::partial_sort(distances.begin(), distances.begin() + static_cast<std::ptrdiff_t>(numResults), distances.end());
+
+    juce::StringArray results;
+    for (size_t i = 0; i < numResults; ++i)
+        results.add(slots[static_cast<size_t>(distances[i].second)].key);
+
+    return results;
+}
+
+PresetSchema::Values PresetSearchIndex::makeFingerprint(const juce::ValueTree& state)
+{
+    PresetSchema::Values fingerprint{};
+
+    for (const auto& child : state)
+    {
+        auto index = PresetSchema::indexOf(child["id"].toString());
+        if (index < 0)
+            continue;
+
+        const auto& parameter = PresetSchema::parameters[index];
+        auto value = static_cast<float>(child["value"]);
+        auto normalised = (value - parameter.minValue) / (parameter.maxValue - parameter.minValue);
+
+        fingerprint[static_cast<size_t>(index)] = juce::jlimit(0.0f, 1.0f, normalised);
+    }
+
+    return fingerprint;
+}
+
+void PresetSearchIndex::addTrigrams(const juce::String& word, bool isPrefix, std::vector<Trigram>& out)
+{
+    // Two leading spaces so one and two letter words still produce trigrams; a
+    // trailing space marks the end of a complete word
+    auto padded = "  " + word + (isPrefix ? "" : " ");
+    auto text = padded.getCharPointer();
+
+    juce::juce_wchar window[3] = { text.getAndAdvance(), text.getAndAdvance(), 0 };
+
+    while (!text.isEmpty())
+    {
+        window[2] = text.getAndAdvance();
+
+        out.push_back((static_cast<Trigram>(window[0]) << 42)
+            | (static_cast<Trigram>(window[1]) << 21)
+            | static_cast<Trigram>(window[2]));
+
+        window[0] = window[1];
+        window[1] = window[2];
+    }
+}
+
+std::vector<PresetSearchIndex::Trigram> PresetSearchIndex::trigramsForText(const juce::String& text)
+{
+    std::vector<Trigram> trigrams;
+
+    for (const auto& word : juce::StringArray::fromTokens(text.toLowerCase(), " \t-_,.;/", ""))
+        if (word.isNotEmpty())
+            addTrigrams(word, false, trigrams);
+
+    std::sort(trigrams.begin(), trigrams.end());
+    trigrams.erase(std::unique(trigrams.begin(), trigrams.end()), trigrams.end());
+    return trigrams;
+}
+
+juce::String PresetSearchIndex::fieldTerm(const juce::String& field, const juce::String& value)
+{
+    return field + ":" + value.toLowerCase().trim();
+}
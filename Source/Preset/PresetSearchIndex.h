@@ -0,0 +1,72 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetSchema.h"
+
+// Search structures over preset metadata, updated one preset at a time.
+//
+// Free text is matched through a trigram inverted index over the name, tags,
+// category and author, so partial words and small typos still match and the
+// word being typed is treated as a prefix. Field filters ("tag:", "category:",
+// "author:") use exact term postings. Similar presets are found by nearest
+// neighbour over normalised parameter vectors stored contiguously.
+//
+// Not thread safe; PresetIndex guards it with its own lock.
+class PresetSearchIndex
+{
+public:
+    struct Document
+    {
+        juce::String key;   // identifies the document; what searches return
+        juce::String name;
+        juce::StringArray tags;
+        juce::String category;
+        juce::String author;
+        PresetSchema::Values fingerprint{};
+    };
+
+    // Replaces any document with the same key
+    void add(const Document& document);
+    void remove(const juce::String& key);
+    void clear();
+
+    int size() const { return static_cast<int>(keyToDocument.size()); }
+
+    // Keys of the best matches first
+    juce::StringArray search(const juce::String& query, int maxResults) const;
+    juce::StringArray findSimilar(const juce::String& key, int maxResults) const;
+    juce::StringArray findSimilar(const PresetSchema::Values& fingerprint, int maxResults) const;
+
+    // Parameter values scaled to 0-1 by the schema ranges, so wide ranges do not
+    // dominate the distance. Missing parameters are 0.
+    static PresetSchema::Values makeFingerprint(const juce::ValueTree& state);
+
+private:
+    using Trigram = juce::uint64;
+
+    struct Slot
+    {
+        juce::String key;
+        juce::String name;
+        juce::String lowerName;
+        std::vector<Trigram> trigrams;
+        juce::StringArray terms;
+        bool alive = false;
+    };
+
+    static void addTrigrams(const juce::String& word, bool isPrefix, std::vector<Trigram>& out);
+    static std::vector<Trigram> trigramsForText(const juce::String& text);
+    static juce::String fieldTerm(const juce::String& field, const juce::String& value);
+
+    juce::StringArray findSimilar(const float* fingerprint, int maxResults, int excludeSlot) const;
+
+    std::vector<Slot> slots;
+    std::vector<int> freeSlots;
+    std::map<juce::String, int> keyToDocument;
+
+    // Slot-major, numParameters floats per slot
+    std::vector<float> fingerprints;
+
+    std::unordered_map<Trigram, std::vector<int>> trigramPostings;
+    std::map<juce::String, std::vector<int>> termPostings;
+};
@@ -0,0 +1,277 @@
+#include "PresetSerialization.h"
+
+namespace
+{
+    const juce::Identifier paramType("PARAM");
+    const juce::Identifier idProperty("id");
+    const juce::Identifier valueProperty("value");
+}
+
+juce::MemoryBlock PresetSerialization::toBinary(const Preset& preset)
+{
+    // Only parameters known to the schema are stored
+    std::vector<std::pair<juce::uint16, float>> values;
+    values.reserve(static_cast<size_t>(preset.state.getNumChildren()));
+
+    for (const auto& child : preset.state)
+    {
+        if (!child.hasType(paramType))
+            continue;
+
+        if (auto stableId = PresetSchema::stableIdFor(child[idProperty].toString()))
+            values.emplace_back(stableId, static_cast<float>(child[valueProperty]));
+    }
+
+    return encode(preset, values);
+}
+
+juce::MemoryBlock PresetSerialization::toBinary(const PresetSchema::Values& parameterValues, const juce::ValueTree& session)
+{
+    std::vector<std::pair<juce::uint16, float>> values;
+    values.reserve(parameterValues.size());
+
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        values.emplace_back(PresetSchema::parameters[i].stableId, parameterValues[static_cast<size_t>(i)]);
+
+    Preset preset;
+    preset.session = session;
+    return encode(preset, values);
+}
+
+bool PresetSerialization::isBinary(const void* data, size_t size)
+{
+    return size >= sizeof(juce::uint32)
+        && juce::ByteOrder::littleEndianInt(data) == binaryMagic;
+}
+
+juce::MemoryBlock PresetSerialization::encode(const Preset& preset,
+    const std::vector<std::pair<juce::uint16, float>>& values)
+{
+    juce::MemoryBlock block;
+    juce::MemoryOutputStream out(block, false);
+
+    out.writeInt(static_cast<int>(binaryMagic));
+    out.writeShort(static_cast<short>(PresetSchema::version));
+    out.writeShort(static_cast<short>(preset.tags.size()));
+    out.writeInt(static_cast<int>(values.size()));
+
+    writeString(out, preset.name);
+    for (const auto& tag : preset.tags)
+        writeString(out, tag);
+
+    writeString(out, preset.category);
+    writeString(out, preset.author);
+
+    for (const auto& [stableId, value] : values)
+    {
+        out.writeShort(static_cast<short>(stableId));
+        out.writeFloat(value);
+    }
+
+    if (preset.session.isValid())
+    {
+        out.writeInt(static_cast<int>(sessionMagic));
+        preset.session.writeToStream(out);
+    }
+
+    out.flush();
+    return block;
+}
+
+bool PresetSerialization::fromBinary(const void* data, size_t size, Preset& preset)
+{
+    juce::MemoryInputStream in(data, size, false);
+
+    if (static_cast<juce::uint32>(in.readInt()) != binaryMagic)
+        return false;
+
+    auto presetVersion = static_cast<int>(static_cast<juce::uint16>(in.readShort()));
+    auto numTags = static_cast<int>(static_cast<juce::uint16>(in.readShort()));
+    auto numValues = in.readInt();
+
+    // Presets from a newer build may use IDs we cannot interpret
+    if (presetVersion > PresetSchema::version || numValues < 0)
+        return false;
+
+    preset.name = readString(in);
+    preset.tags.clearQuick();
+    for (int i = 0; i < numTags; ++i)
+        preset.tags.add(readString(in));
+
+    preset.category = presetVersion >= 2 ? readString(in) : juce::String();
+    preset.author = presetVersion >= 2 ? readString(in) : juce::String();
+
+    constexpr int bytesPerValue = 2 + 4;
+    if (in.getNumBytesRemaining() < static_cast<juce::int64>(numValues) * bytesPerValue)
+        return false;
+
+    // Build the state tree directly; no XML is involved
+    juce::ValueTree state(PresetSchema::stateType);
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        auto stableId = static_cast<juce::uint16>(in.readShort());
+        auto value = in.readFloat();
+
+        stableId = PresetSchema::migrateStableId(stableId, presetVersion);
+
+        if (auto* parameterId = PresetSchema::parameterIdFor(stableId))
+            state.appendChild(juce::ValueTree(paramType, { { idProperty, parameterId }, { valueProperty, value } }), nullptr);
+    }
+
+    preset.state = state;
+
+    // A damaged session is dropped rather than failing the parameters
+    preset.session = {};
+    if (in.getNumBytesRemaining() >= static_cast<juce::int64>(sizeof(juce::uint32))
+        && static_cast<juce::uint32>(in.readInt()) == sessionMagic)
+        preset.session = juce::ValueTree::readFromStream(in);
+
+    return true;
+}
+
+juce::String PresetSerialization::toLegacyJson(const Preset& preset)
+{
+    juce::DynamicObject::Ptr presetObject = new juce::DynamicObject();
+    presetObject->setProperty("name", preset.name);
+    presetObject->setProperty("version", "1.0");
+    presetObject->setProperty("timestamp", juce::Time::getCurrentTime().toISO8601(false));
+
+    if (auto xml = preset.state.createXml())
+        presetObject->setProperty("state", xml->toString());
+
+    juce::Array<juce::var> tagArray;
+    for (const auto& tag : preset.tags)
+        tagArray.add(tag);
+    presetObject->setProperty("tags", tagArray);
+    presetObject->setProperty("category", preset.category);
+    presetObject->setProperty("author", preset.author);
+
+    return juce::JSON::toString(juce::var(presetObject.get()));
+}
+
+bool PresetSerialization::fromLegacyJson(const juce::String& json, Preset& preset)
+{
+    auto presetVar = juce::JSON::parse(json);
+    auto* presetObject = presetVar.getDynamicObject();
+
+    if (presetObject == nullptr || !presetObject->hasProperty("state"))
+        return false;
+
+    auto stateVar = presetObject->getProperty("state");
+    if (!stateVar.isString())
+        return false;
+
+    auto xmlState = juce::XmlDocument::parse(stateVar.toString());
+    if (xmlState == nullptr)
+        return false;
+
+    auto legacyState = juce::ValueTree::fromXml(*xmlState);
+    if (!legacyState.isValid())
+        return false;
+
+    // Carry values across under their current parameter names
+    juce::ValueTree state(PresetSchema::stateType);
+
+    for (const auto& child : legacyState)
+    {
+        if (!child.hasType(paramType))
+            continue;
+
+        auto parameterId = PresetSchema::migrateParameterId(child[idProperty].toString());
+        if (parameterId.isNotEmpty())
+            state.appendChild(juce::ValueTree(paramType, { { idProperty, parameterId }, { valueProperty, child[valueProperty] } }), nullptr);
+    }
+
+    preset.name = presetObject->getProperty("name").toString();
+    preset.category = presetObject->getProperty("category").toString();
+    preset.author = presetObject->getProperty("author").toString();
+    preset.state = state;
+    preset.tags.clearQuick();
+
+    if (auto* tagArray = presetObject->getProperty("tags").getArray())
+        for (const auto& tag : *tagArray)
+            preset.tags.add(tag.toString());
+
+    return true;
+}
+
+bool PresetSerialization::readFile(const juce::File& file, Preset& preset)
+{
+    bool loaded = false;
+
+    if (file.hasFileExtension(binaryExtension))
+    {
+        juce::MemoryBlock data;
+        loaded = file.loadFileAsData(data) && fromBinary(data.getData(), data.getSize(), preset);
+    }
+    else if (file.hasFileExtension(legacyExtension))
+    {
+        loaded = fromLegacyJson(file.loadFileAsString(), preset);
+    }
+
+    // The file name is authoritative; older files may not store a name at all
+    if (loaded)
+        preset.name = file.getFileNameWithoutExtension();
+
+    return loaded;
+}
+
+bool PresetSerialization::writeFile(const juce::File& file, const Preset& preset)
+{
+    auto data = toBinary(preset);
+
+    // Write next to the target, sync, then rename over it, so a crash leaves
+    // either the old preset or the new one but never a truncated file
+    juce::TemporaryFile temp(file);
+
+    {
+        juce::FileOutputStream out(temp.getFile());
+
+        if (!out.openedOk() || !out.write(data.getData(), data.getSize()))
+            return false;
+
+        out.flush();
+
+        if (out.getStatus().failed())
+            return false;
+    }
+
+    return temp.overwriteTargetFileWithTemporary();
+}
+
+bool PresetSerialization::isPresetFile(const juce::File& file)
+{
+    return file.hasFileExtension(binaryExtension) || file.hasFileExtension(legacyExtension);
+}
+
+juce::ValueTree PresetSerialization::makeState(const PresetSchema::Values& values)
+{
+    juce::ValueTree state(PresetSchema::stateType);
+
+    for (int i = 0; i < PresetSchema::numParameters; ++i)
+        state.appendChild(juce::ValueTree(paramType, { { idProperty, PresetSchema::parameters[i].parameterId },
+                                                       { valueProperty, values[static_cast<size_t>(i)] } }), nullptr);
+
+    return state;
+}
+
+void PresetSerialization::writeString(juce::MemoryOutputStream& out, const juce::String& text)
+{
+    auto utf8 = text.toRawUTF8();
+    auto numBytes = juce::jmin(text.getNumBytesAsUTF8(), static_cast<size_t>(0xffff));
+
+    out.writeShort(static_cast<short>(numBytes));
+    out.write(utf8, numBytes);
+}
+
+juce::String PresetSerialization::readString(juce::MemoryInputStream& in)
+{
+    auto numBytes = static_cast<size_t>(static_cast<juce::uint16>(in.readShort()));
+    numBytes = juce::jmin(numBytes, static_cast<size_t>(in.getNumBytesRemaining()));
+
+    auto* start = static_cast<const char*>(in.getData()) + in.getPosition();
+    in.skipNextBytes(static_cast<juce::int64>(numBytes));
+
+    return juce::String::fromUTF8(start, static_cast<int>(numBytes));
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetSchema.h"
+
+// Reads and writes preset files.
+//
+// Binary layout (little endian):
+//   char[4]  magic "MPRS"
+//   uint16   schema version
+//   uint16   number of tags
+//   uint32   number of parameter values
+//   string   name (uint16 byte length + UTF-8), then each tag the same way
+//   string   category, then author (version 2 and later)
+//   values   uint16 stable ID + float32 plain value, repeated
+//   session  optional: char[4] magic "MSES" + ValueTree::writeToStream data
+//
+// Only the host state chunk carries a session (modulation routes, the movement script);
+// builds that predate it stop reading after the values.
+//
+// Legacy .preset files are JSON with the APVTS state embedded as an XML string;
+// they are still read, with parameter names migrated through PresetSchema.
+class PresetSerialization
+{
+public:
+    struct Preset
+    {
+        juce::String name;
+        juce::StringArray tags;
+        juce::ValueTree state;
+        juce::String category;
+        juce::String author;
+
+        // Host state chunk only; invalid for preset files
+        juce::ValueTree session;
+    };
+
+    static constexpr const char* binaryExtension = ".mpreset";
+    static constexpr const char* legacyExtension = ".preset";
+
+    static juce::MemoryBlock toBinary(const Preset& preset);
+    static bool fromBinary(const void* data, size_t size, Preset& preset);
+
+    // Unnamed binary block straight from plain values in schema order, plus the
+    // session tree if valid; used for the host state chunk
+    static juce::MemoryBlock toBinary(const PresetSchema::Values& values, const juce::ValueTree& session = {});
+    static bool isBinary(const void* data, size_t size);
+
+    static juce::String toLegacyJson(const Preset& preset);
+    static bool fromLegacyJson(const juce::String& json, Preset& preset);
+
+    // readFile dispatches on the file extension; writeFile always writes binary,
+    // atomically replacing any existing file
+    static bool readFile(const juce::File& file, Preset& preset);
+    static bool writeFile(const juce::File& file, const Preset& preset);
+
+    static bool isPresetFile(const juce::File& file);
+
+    // Parameter state tree from plain values in schema order
+    static juce::ValueTree makeState(const PresetSchema::Values& values);
+
+private:
+    static constexpr juce::uint32 binaryMagic = 0x5352504d; // "MPRS"
+    static constexpr juce::uint32 sessionMagic = 0x5345534d; // "MSES"
+
+    static juce::MemoryBlock encode(const Preset& preset, const std::vector<std::pair<juce::uint16, float>>& values);
+    static void writeString(juce::MemoryOutputStream& out, const juce::String& text);
+    static juce::String readString(juce::MemoryInputStream& in);
+};
@@ -0,0 +1,144 @@
+#include "ProgramBank.h"
+#include "FactoryPresets.h"
+
+ProgramBank::ProgramBank(PresetManager& presets, PresetMorphEngine& morph)
+    : presetManager(presets), morphEngine(morph)
+{
+    presetManager.getPresetIndex().addChangeListener(this);
+
+    // Hosts read the program list as soon as the plugin is created, so the
+    // factory programs are there from the start; user presets follow from rebuild()
+    juce::StringArray factoryNames;
+    for (const auto& preset : FactoryPresets::presets)
+        factoryNames.add(preset.name);
+
+    publish(factoryNames, { FactoryPresets::values.begin(), FactoryPresets::values.end() },
+        std::vector<bool>(FactoryPresets::values.size(), true));
+    rebuild();
+    startTimerHz(notifyTimerHz);
+}
+
+ProgramBank::~ProgramBank()
+{
+    stopTimer();
+    presetManager.getPresetIndex().removeChangeListener(this);
+}
+
+int ProgramBank::getNumPrograms() const
+{
+    const juce::ScopedLock sl(namesLock);
+
+    // Hosts expect at least one program
+    return juce::jmax(1, programNames.size());
+}
+
+juce::String ProgramBank::getProgramName(int index) const
+{
+    const juce::ScopedLock sl(namesLock);
+    return programNames[index];
+}
+
+void ProgramBank::selectProgram(int index)
+{
+    if (ownedBank == nullptr || !juce::isPositiveAndBelow(index, static_cast<int>(ownedBank->snapshots.size()))
+        || !ownedBank->valid[static_cast<size_t>(index)])
+        return;
+
+    currentProgram.store(index);
+    presetManager.applySnapshot(getProgramName(index), ownedBank->snapshots[static_cast<size_t>(index)], 0.0);
+}
+
+void ProgramBank::processMidi(const juce::MidiBuffer& midiMessages)
+{
+    int program = -1;
+
+    for (const auto metadata : midiMessages)
+    {
+        const auto message = metadata.getMessage();
+
+        if (message.isProgramChange())
+            program = message.getProgramChangeNumber();
+    }
+
+    if (program < 0)
+        return;
+
+    auto* bank = bankSlot.exchange(nullptr, std::memory_order_acquire);
+    if (bank == nullptr)
+        return;
+
+    // Unreadable presets are skipped rather than jumping to made-up values
+    if (program < static_cast<int>(bank->snapshots.size()) && bank->valid[static_cast<size_t>(program)])
+    {
+        morphEngine.jumpTo(bank->snapshots[static_cast<size_t>(program)]);
+        currentProgram.store(program);
+        midiProgramChanged.store(true);
+    }
+
+    bankSlot.store(bank, std::memory_order_release);
+}
+
+void ProgramBank::rebuild()
+{
+    presetManager.loadBankSnapshots([safeThis = juce::WeakReference<ProgramBank>(this)](const juce::StringArray& names,
+                                                                                       const std::vector<PresetSchema::Values>& snapshots,
+                                                                                       const std::vector<bool>& valid)
+    {
+        if (safeThis != nullptr)
+            safeThis->publish(names, snapshots, valid);
+    });
+}
+
+void ProgramBank::publish(const juce::StringArray& names, const std::vector<PresetSchema::Values>& snapshots,
+    const std::vector<bool>& valid)
+{
+    jassert(valid.size() == snapshots.size());
+
+    auto next = std::make_unique<Bank>();
+    next->snapshots = snapshots;
+    next->valid = valid;
+
+    // Only succeeds while the audio thread is not holding the current bank
+    auto* expected = ownedBank.get();
+    while (!bankSlot.compare_exchange_weak(expected, next.get(), std::memory_order_acq_rel))
+    {
+        expected = ownedBank.get();
+        juce::Thread::yield();
+    }
+
+    ownedBank = std::move(next);
+
+    bool namesChanged;
+
+    {
+        const juce::ScopedLock sl(namesLock);
+        namesChanged = programNames != names;
+        programNames = names;
+    }
+
+    // Keep the current program pointing at the same preset if it moved
+    auto current = currentProgram.load();
+    auto currentIndex = names.indexOf(presetManager.getCurrentPresetName());
+    bool indexChanged = currentIndex >= 0 && currentIndex != current;
+    if (indexChanged)
+        currentProgram.store(currentIndex);
+
+    if ((namesChanged || indexChanged) && onProgramChanged != nullptr)
+        onProgramChanged();
+}
+
+void ProgramBank::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    rebuild();
+}
+
+void ProgramBank::timerCallback()
+{
+    if (!midiProgramChanged.exchange(false))
+        return;
+
+    presetManager.setCurrentPresetName(getProgramName(currentProgram.load()));
+
+    if (onProgramChanged != nullptr)
+        onProgramChanged();
+}
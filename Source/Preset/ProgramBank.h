@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "PresetManager.h"
+#include "PresetMorphEngine.h"
+
+// Exposes the preset bank (factory presets, then user presets) as host programs.
+//
+// Every program's snapshot is resolved ahead of time into one flat array, rebuilt
+// whenever the preset list changes. A MIDI Program Change handled on the audio
+// thread copies its snapshot straight into the parameters through the morph
+// engine, with no allocation or locking; the host and the preset manager are told
+// afterwards from the message thread. MIDI reaches the first 128 programs.
+class ProgramBank : private juce::ChangeListener,
+    private juce::Timer
+{
+public:
+    ProgramBank(PresetManager& presets, PresetMorphEngine& morph);
+    ~ProgramBank() override;
+
+    // Any thread
+    int getNumPrograms() const;
+    juce::String getProgramName(int index) const;
+    int getCurrentProgram() const { return currentProgram.load(); }
+
+    // Message thread (host setCurrentProgram)
+    void selectProgram(int index);
+
+    // Audio thread: applies the last Program Change in the buffer
+    void processMidi(const juce::MidiBuffer& midiMessages);
+
+    // Called on the message thread after a program was switched from MIDI, or
+    // when the program list or the current program's position in it changed
+    std::function<void()> onProgramChanged;
+
+private:
+    struct Bank
+    {
+        std::vector<PresetSchema::Values> snapshots;
+        std::vector<bool> valid; // false for presets that could not be read
+    };
+
+    void rebuild();
+    void publish(const juce::StringArray& names, const std::vector<PresetSchema::Values>& snapshots,
+        const std::vector<bool>& valid);
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void timerCallback() override;
+
+    PresetManager& presetManager;
+    PresetMorphEngine& morphEngine;
+
+    // Owned by the message thread; the audio thread borrows it by swapping the
+    // slot to nullptr for the duration of processMidi, so publish() waits for it
+    // to come back before freeing the old bank
+    std::unique_ptr<Bank> ownedBank;
+    std::atomic<Bank*> bankSlot{ nullptr };
+
+    mutable juce::CriticalSection namesLock;
+    juce::StringArray programNames;
+
+    std::atomic<int> currentProgram{ 0 };
+    std::atomic<bool> midiProgramChanged{ false };
+
+    static constexpr int notifyTimerHz = 30;
+
+    JUCE_DECLARE_WEAK_REFERENCEABLE(ProgramBank)
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProgramBank)
+};
@@ -0,0 +1,237 @@
+#include "SpectrumAnalyser.h"
+
+SpectrumAnalyser::SpectrumAnalyser(AnalyserFeed& feedToUse)
+    : feed(feedToUse)
+{
+    incoming.calloc(AnalyserFeed::capacity);
+    bandLevels.fill(minDb);
+
+    spectrumPath.preallocateSpace(numBands * 3 + 8);
+    scopePath.preallocateSpace(scopeLength * 3 + 8);
+
+    setOpaque(true);
+    feed.setEnabled(true);
+}
+
+SpectrumAnalyser::~SpectrumAnalyser()
+{
+    feed.setEnabled(false);
+}
+
+void SpectrumAnalyser::refresh()
+{
+    auto numPulled = feed.pull(incoming.get(), AnalyserFeed::capacity);
+    if (numPulled == 0 || !isShowing())
+        return;
+
+    auto sampleRate = feed.getSampleRate();
+    if (sampleRate != bandSampleRate)
+        updateBandEdges(sampleRate);
+
+    // After a stall only the newest audio is worth analysing
+    const auto* samples = incoming.get();
+    auto maxUseful = fftSize + hopSize * maxFramesPerRefresh;
+    if (numPulled > maxUseful)
+    {
+        samples += numPulled - maxUseful;
+        numPulled = maxUseful;
+    }
+
+    bool analysed = false;
+
+    for (int consumed = 0; consumed < numPulled;)
+    {
+        auto chunk = juce::jmin(hopSize - samplesSinceFrame, numPulled - consumed);
+        appendToHistory(samples + consumed, chunk);
+        consumed += chunk;
+        samplesSinceFrame += chunk;
+
+        if (samplesSinceFrame == hopSize)
+        {
+            analyseFrame();
+            samplesSinceFrame = 0;
+            analysed = true;
+        }
+    }
+
+    if (analysed)
+    {
+        rebuildSpectrumPath();
+        repaint(spectrumArea);
+    }
+
+    rebuildScopePath();
+    repaint(scopeArea);
+}
+
+void SpectrumAnalyser::paint(juce::Graphics& g)
+{
+    g.drawImageAt(gridImage, 0, 0);
+
+    g.setColour(juce::Colours::cyan.withAlpha(0.25f));
+    g.fillPath(spectrumPath);
+    g.setColour(juce::Colours::cyan);
+    g.strokePath(spectrumPath, juce::PathStrokeType(1.5f));
+
+    g.setColour(juce::Colours::orange);
+    g.strokePath(scopePath, juce::PathStrokeType(1.0f));
+}
+
+void SpectrumAnalyser::resized()
+{
+    auto area = getLocalBounds();
+    scopeArea = area.removeFromRight(area.getWidth() / 3).reduced(4);
+    spectrumArea = area.reduced(4);
+
+    renderGrid();
+    rebuildSpectrumPath();
+    rebuildScopePath();
+}
+
+void SpectrumAnalyser::appendToHistory(const float* samples, int numSamples)
+{
+    std::memmove(history.data(), history.data() + numSamples, sizeof(float) * static_cast<size_t>(fftSize - numSamples));
+    std::copy(samples, samples + numSamples, history.end() - numSamples);
+}
+
+void SpectrumAnalyser::analyseFrame()
+{
+    std::copy(history.begin(), history.end(), fftData.begin());
+    window.multiplyWithWindowingTable(fftData.data(), static_cast<size_t>(fftSize));
+    fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+    // A full scale sine reads 0 dB: two sides of the spectrum, Hann gain of 0.5
+    const auto scale = 4.0f / static_cast<float>(fftSize);
+
+    for (int band = 0; band < numBands; ++band)
+    {
+        float magnitude = 0.0f;
+        for (int bin = bandEdges[static_cast<size_t>(band)]; bin < bandEdges[static_cast<size_t>(band) + 1]; ++bin)
+            magnitude = juce::jmax(magnitude, fftData[static_cast<size_t>(bin)]);
+
+        auto db = juce::Decibels::gainToDecibels(magnitude * scale, minDb);
+        auto& level = bandLevels[static_cast<size_t>(band)];
+        level += (db - level) * averaging;
+    }
+}
+
+void SpectrumAnalyser::updateBandEdges(double sampleRate)
+{
+    bandSampleRate = sampleRate;
+
+    auto binWidth = static_cast<float>(sampleRate) / static_cast<float>(fftSize);
+    auto top = juce::jmin(maxFrequency, static_cast<float>(sampleRate) * 0.5f);
+    auto ratio = std::log(top / minFrequency);
+
+    for (int edge = 0; edge <= numBands; ++edge)
+    {
+        auto frequency = minFrequency * std::exp(ratio * static_cast<float>(edge) / numBands);
+        bandEdges[static_cast<size_t>(edge)] = juce::jlimit(1, fftSize / 2, juce::roundToInt(frequency / binWidth));
+    }
+
+    // Low bands narrower than one bin still read the bin they sit in
+    for (int band = 0; band < numBands; ++band)
+    {
+        auto& end = bandEdges[static_cast<size_t>(band) + 1];
+        end = juce::jmax(end, bandEdges[static_cast<size_t>(band)] + 1);
+        bandCentres[static_cast<size_t>(band)] = minFrequency * std::exp(ratio * (static_cast<float>(band) + 0.5f) / numBands);
+    }
+}
+
+void SpectrumAnalyser::rebuildSpectrumPath()
+{
+    spectrumPath.clear();
+
+    if (spectrumArea.isEmpty() || bandSampleRate <= 0.0)
+        return;
+
+    auto bottom = static_cast<float>(spectrumArea.getBottom());
+    spectrumPath.startNewSubPath(frequencyToX(bandCentres.front()), bottom);
+
+    for (int band = 0; band < numBands; ++band)
+        spectrumPath.lineTo(frequencyToX(bandCentres[static_cast<size_t>(band)]), dbToY(bandLevels[static_cast<size_t>(band)]));
+
+    spectrumPath.lineTo(frequencyToX(bandCentres.back()), bottom);
+    spectrumPath.closeSubPath();
+}
+
+void SpectrumAnalyser::rebuildScopePath()
+{
+    scopePath.clear();
+
+    if (scopeArea.isEmpty())
+        return;
+
+    // Start on a rising zero crossing so periodic sounds stand still
+    auto start = fftSize - scopeLength;
+    for (int i = fftSize - scopeLength; i > fftSize - scopeLength * 2 && i > 0; --i)
+    {
+        if (history[static_cast<size_t>(i) - 1] < 0.0f && history[static_cast<size_t>(i)] >= 0.0f)
+        {
+            start = i;
+            break;
+        }
+    }
+
+    auto area = scopeArea.toFloat();
+    auto xScale = area.getWidth() / static_cast<float>(scopeLength - 1);
+    auto centre = area.getCentreY();
+    auto yScale = area.getHeight() * 0.5f;
+
+    for (int i = 0; i < scopeLength; ++i)
+    {
+        auto x = area.getX() + static_cast<float>(i) * xScale;
+        auto y = centre - juce::jlimit(-1.0f, 1.0f, history[static_cast<size_t>(start + i)]) * yScale;
+
+        if (i == 0)
+            scopePath.startNewSubPath(x, y);
+        else
+            scopePath.lineTo(x, y);
+    }
+}
+
+void SpectrumAnalyser::renderGrid()
+{
+    if (getWidth() <= 0 || getHeight() <= 0)
+        return;
+
+    gridImage = juce::Image(juce::Image::RGB, getWidth(), getHeight(), true);
+    juce::Graphics g(gridImage);
+
+    g.fillAll(juce::Colour(0xff1a1a1a));
+    g.setFont(10.0f);
+
+    for (auto frequency : { 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 2000.0f, 5000.0f, 10000.0f })
+    {
+        auto x = frequencyToX(frequency);
+        g.setColour(juce::Colour(0xff333333));
+        g.drawVerticalLine(juce::roundToInt(x), static_cast<float>(spectrumArea.getY()), static_cast<float>(spectrumArea.getBottom()));
+
+        g.setColour(juce::Colours::grey);
+        auto label = frequency >= 1000.0f ? juce::String(frequency / 1000.0f) + "k" : juce::String(frequency);
+        g.drawText(label, juce::roundToInt(x) + 2, spectrumArea.getBottom() - 12, 30, 12, juce::Justification::left);
+    }
+
+    for (float db = minDb + 10.0f; db < maxDb; db += 20.0f)
+    {
+        g.setColour(juce::Colour(0xff333333));
+        g.drawHorizontalLine(juce::roundToInt(dbToY(db)), static_cast<float>(spectrumArea.getX()), static_cast<float>(spectrumArea.getRight()));
+    }
+
+    g.setColour(juce::Colour(0xff333333));
+    g.drawHorizontalLine(scopeArea.getCentreY(), static_cast<float>(scopeArea.getX()), static_cast<float>(scopeArea.getRight()));
+    g.drawRect(scopeArea);
+    g.drawRect(spectrumArea);
+}
+
+float SpectrumAnalyser::frequencyToX(float frequency) const
+{
+    auto proportion = std::log(frequency / minFrequency) / std::log(maxFrequency / minFrequency);
+    return static_cast<float>(spectrumArea.getX()) + proportion * static_cast<float>(spectrumArea.getWidth());
+}
+
+float SpectrumAnalyser::dbToY(float db) const
+{
+    auto proportion = (juce::jlimit(minDb, maxDb, db) - minDb) / (maxDb - minDb);
+    return static_cast<float>(spectrumArea.getBottom()) - proportion * static_cast<float>(spectrumArea.getHeight());
+}
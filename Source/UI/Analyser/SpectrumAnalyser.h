@@ -0,0 +1,69 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../AudioEngine/AnalyserFeed.h"
+
+// Output spectrum and oscilloscope, fed from the processor's AnalyserFeed.
+//
+// Switches the feed on while it exists, so closing the editor stops the audio
+// thread from copying anything. refresh() is driven by the editor's shared timer:
+// it drains the feed, runs a Hann-windowed FFT every hop, averages the result in
+// log-spaced bands and rebuilds the two paths. The grid is drawn once per resize
+// into a cached image. All buffers are allocated up front.
+class SpectrumAnalyser : public juce::Component
+{
+public:
+    explicit SpectrumAnalyser(AnalyserFeed& feedToUse);
+    ~SpectrumAnalyser() override;
+
+    void refresh();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    static constexpr int fftOrder = 11;
+    static constexpr int fftSize = 1 << fftOrder;
+    static constexpr int hopSize = fftSize / 2;
+    static constexpr int maxFramesPerRefresh = 4;
+    static constexpr int numBands = 192;
+    static constexpr int scopeLength = 1024;
+
+    static constexpr float minFrequency = 20.0f;
+    static constexpr float maxFrequency = 20000.0f;
+    static constexpr float minDb = -90.0f;
+    static constexpr float maxDb = 0.0f;
+    static constexpr float averaging = 0.35f;
+
+    void appendToHistory(const float* samples, int numSamples);
+    void analyseFrame();
+    void updateBandEdges(double sampleRate);
+    void rebuildSpectrumPath();
+    void rebuildScopePath();
+    void renderGrid();
+
+    float frequencyToX(float frequency) const;
+    float dbToY(float db) const;
+
+    AnalyserFeed& feed;
+
+    juce::dsp::FFT fft{ fftOrder };
+    juce::dsp::WindowingFunction<float> window{ static_cast<size_t>(fftSize), juce::dsp::WindowingFunction<float>::hann, false };
+
+    juce::HeapBlock<float> incoming;
+    std::array<float, fftSize> history{};
+    std::array<float, fftSize * 2> fftData{};
+    int samplesSinceFrame = 0;
+
+    // FFT bin range covered by each band, and the averaged level in dB
+    std::array<int, numBands + 1> bandEdges{};
+    std::array<float, numBands> bandCentres{};
+    std::array<float, numBands> bandLevels{};
+    double bandSampleRate = 0.0;
+
+    juce::Rectangle<int> spectrumArea, scopeArea;
+    juce::Image gridImage;
+    juce::Path spectrumPath, scopePath;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SpectrumAnalyser)
+};
@@ -0,0 +1,59 @@
+#include "CpuLoadView.h"
+
+void CpuLoadView::addStage(const CpuLoadMeter& meter, const juce::String& name)
+{
+    Row row;
+    row.meter = &meter;
+    row.name = name;
+    rows.push_back(row);
+}
+
+void CpuLoadView::refresh()
+{
+    for (int i = 0; i < static_cast<int>(rows.size()); ++i)
+    {
+        auto& row = rows[static_cast<size_t>(i)];
+        auto average = juce::roundToInt(row.meter->getAverage() * 1000.0f);
+        auto peak = juce::roundToInt(row.meter->getPeak() * 1000.0f);
+
+        if (average == row.average && peak == row.peak)
+            continue;
+
+        row.average = average;
+        row.peak = peak;
+        repaint(getRowBounds(i));
+    }
+}
+
+void CpuLoadView::paint(juce::Graphics& g)
+{
+    g.setFont(12.0f);
+
+    for (int i = 0; i < static_cast<int>(rows.size()); ++i)
+    {
+        const auto& row = rows[static_cast<size_t>(i)];
+        auto bounds = getRowBounds(i);
+
+        if (!g.clipRegionIntersects(bounds))
+            continue;
+
+        g.setColour(juce::Colour(0xff1a1a1a));
+        g.fillRect(bounds);
+
+        // Colour by peak: a stage near the whole budget on its own is trouble
+        auto peakPercent = row.peak / 10.0f;
+        g.setColour(peakPercent > 50.0f ? juce::Colours::red
+                    : peakPercent > 20.0f ? juce::Colours::orange
+                    : juce::Colours::white);
+
+        auto text = bounds.reduced(4, 0);
+        g.drawText(row.name, text.removeFromLeft(60), juce::Justification::centredLeft);
+        g.drawText(juce::String(juce::jmax(0, row.average) / 10.0f, 1) + "%", text.removeFromLeft(55), juce::Justification::centredRight);
+        g.drawText("pk " + juce::String(peakPercent < 0.0f ? 0.0f : peakPercent, 1) + "%", text, juce::Justification::centredRight);
+    }
+}
+
+juce::Rectangle<int> CpuLoadView::getRowBounds(int index) const
+{
+    return { 0, index * rowHeight, getWidth(), rowHeight - 1 };
+}
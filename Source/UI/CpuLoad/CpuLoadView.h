@@ -0,0 +1,40 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../AudioEngine/CpuLoadMeter.h"
+
+// Text table of CPU load per processing stage, as a percentage of the real-time
+// budget: average and peak. refresh() comes from the editor's shared timer and
+// only repaints rows whose displayed numbers changed.
+class CpuLoadView : public juce::Component
+{
+public:
+    CpuLoadView() = default;
+    ~CpuLoadView() override = default;
+
+    // Meters must outlive this component
+    void addStage(const CpuLoadMeter& meter, const juce::String& name);
+
+    void refresh();
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    struct Row
+    {
+        const CpuLoadMeter* meter = nullptr;
+        juce::String name;
+
+        // Last shown values, in tenths of a percent
+        int average = -1;
+        int peak = -1;
+    };
+
+    juce::Rectangle<int> getRowBounds(int index) const;
+
+    std::vector<Row> rows;
+
+    static constexpr int rowHeight = 17;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(CpuLoadView)
+};
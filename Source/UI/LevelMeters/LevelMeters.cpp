@@ -0,0 +1,102 @@
+#include "LevelMeters.h"
+
+void LevelMeters::addMeter(LevelMeter& meter, const juce::String& name)
+{
+    Channel channel;
+    channel.meter = &meter;
+    channel.name = name;
+    channels.push_back(channel);
+
+    resized();
+}
+
+void LevelMeters::refresh()
+{
+    for (auto& channel : channels)
+    {
+        auto barHeight = channel.barBounds.getHeight();
+        auto peakHeight = levelToHeight(channel.meter->getPeak(), barHeight);
+        auto rmsHeight = levelToHeight(channel.meter->getRms(), barHeight);
+        auto clipped = channel.meter->hasClipped();
+
+        if (peakHeight == channel.peakHeight && rmsHeight == channel.rmsHeight && clipped == channel.clipped)
+            continue;
+
+        channel.peakHeight = peakHeight;
+        channel.rmsHeight = rmsHeight;
+        channel.clipped = clipped;
+
+        repaint(channel.bounds);
+    }
+}
+
+void LevelMeters::paint(juce::Graphics& g)
+{
+    auto clip = g.getClipBounds();
+
+    for (const auto& channel : channels)
+    {
+        if (!clip.intersects(channel.bounds))
+            continue;
+
+        auto bar = channel.barBounds;
+
+        g.setColour(juce::Colour(0xff1a1a1a));
+        g.fillRect(bar);
+
+        // RMS as the solid bar, peak as a line above it
+        g.setColour(juce::Colours::limegreen.darker(0.3f));
+        g.fillRect(bar.withTop(bar.getBottom() - channel.rmsHeight));
+
+        g.setColour(channel.peakHeight >= bar.getHeight() ? juce::Colours::red : juce::Colours::yellow);
+        g.fillRect(bar.getX(), bar.getBottom() - channel.peakHeight, bar.getWidth(), 2);
+
+        auto clipLight = channel.bounds.withHeight(clipHeight);
+        g.setColour(channel.clipped ? juce::Colours::red : juce::Colour(0xff3a3a3a));
+        g.fillRect(clipLight);
+
+        g.setColour(juce::Colours::white);
+        g.setFont(12.0f);
+        g.drawFittedText(channel.name, channel.bounds.withTop(channel.bounds.getBottom() - labelHeight),
+            juce::Justification::centred, 1);
+    }
+}
+
+void LevelMeters::resized()
+{
+    if (channels.empty())
+        return;
+
+    auto area = getLocalBounds();
+    auto width = area.getWidth() / static_cast<int>(channels.size());
+
+    for (auto& channel : channels)
+    {
+        channel.bounds = area.removeFromLeft(width).reduced(4, 0);
+
+        auto bar = channel.bounds.withTrimmedTop(clipHeight + 2).withTrimmedBottom(labelHeight + 2);
+        channel.barBounds = bar.withSizeKeepingCentre(juce::jmin(16, bar.getWidth()), bar.getHeight());
+
+        // Force the next refresh to repaint
+        channel.peakHeight = -1;
+    }
+}
+
+void LevelMeters::mouseDown(const juce::MouseEvent& event)
+{
+    for (auto& channel : channels)
+    {
+        if (channel.bounds.contains(event.getPosition()))
+        {
+            channel.meter->clearClip();
+            refresh();
+        }
+    }
+}
+
+int LevelMeters::levelToHeight(float level, int barHeight) const
+{
+    auto db = juce::Decibels::gainToDecibels(level, minDb);
+    auto proportion = juce::jlimit(0.0f, 1.0f, (db - minDb) / -minDb);
+    return juce::roundToInt(proportion * static_cast<float>(barHeight));
+}
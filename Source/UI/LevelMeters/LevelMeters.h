@@ -0,0 +1,49 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../AudioEngine/LevelMeter.h"
+
+// A row of vertical peak/RMS meters, one per bus.
+//
+// Has no timer of its own: the editor calls refresh() from its shared timer, which
+// reads the meters' atomics and repaints only the meters whose drawn height
+// changed. Clicking a meter clears its clip light.
+class LevelMeters : public juce::Component
+{
+public:
+    LevelMeters() = default;
+    ~LevelMeters() override = default;
+
+    // Meters must outlive this component
+    void addMeter(LevelMeter& meter, const juce::String& name);
+
+    void refresh();
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+    void mouseDown(const juce::MouseEvent& event) override;
+
+private:
+    struct Channel
+    {
+        LevelMeter* meter = nullptr;
+        juce::String name;
+        juce::Rectangle<int> bounds;
+        juce::Rectangle<int> barBounds;
+
+        // What was last painted, in pixels from the bottom of the bar
+        int peakHeight = 0;
+        int rmsHeight = 0;
+        bool clipped = false;
+    };
+
+    int levelToHeight(float level, int barHeight) const;
+
+    std::vector<Channel> channels;
+
+    static constexpr float minDb = -60.0f;
+    static constexpr int labelHeight = 15;
+    static constexpr int clipHeight = 6;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(LevelMeters)
+};
@@ -0,0 +1,167 @@
+#include "ModulePanel.h"
+
+ModulePanel::ModulePanel(const Spec& spec, juce::AudioProcessorValueTreeState& vts)
+    : valueTreeState(vts), colour(spec.colour)
+{
+    for (const auto& control : spec.controls)
+    {
+        auto* parameter = valueTreeState.getParameter(control.parameterId);
+        jassert(parameter != nullptr); // Spec out of step with the parameter layout
+
+        if (parameter == nullptr)
+            continue;
+
+        auto widget = std::make_unique<Widget>();
+        widget->parameterId = control.parameterId;
+
+        if (dynamic_cast<juce::AudioParameterBool*>(parameter) != nullptr)
+        {
+            widget->toggle = std::make_unique<juce::ToggleButton>(control.label);
+            addAndMakeVisible(*widget->toggle);
+        }
+        else if (auto* choice = dynamic_cast<juce::AudioParameterChoice*>(parameter))
+        {
+            widget->combo = std::make_unique<juce::ComboBox>();
+            widget->combo->addItemList(choice->choices, 1);
+            addAndMakeVisible(*widget->combo);
+
+            widget->label.setText(control.label, juce::dontSendNotification);
+            widget->label.attachToComponent(widget->combo.get(), false);
+            addAndMakeVisible(widget->label);
+        }
+        else
+        {
+            widget->slider = std::make_unique<juce::Slider>(juce::Slider::LinearHorizontal, juce::Slider::TextBoxRight);
+            widget->slider->setTextBoxStyle(juce::Slider::TextBoxRight, false, 50, 20);
+            addAndMakeVisible(*widget->slider);
+
+            widget->label.setText(control.label, juce::dontSendNotification);
+            widget->label.attachToComponent(widget->slider.get(), false);
+            addAndMakeVisible(widget->label);
+        }
+
+        widget->label.setBufferedToImage(true);
+        widgets.push_back(std::move(widget));
+    }
+
+    if (spec.hasTrigger)
+    {
+        triggerButton = std::make_unique<juce::TextButton>("Trigger");
+        triggerButton->onClick = [this]
+        {
+            if (onTrigger != nullptr)
+                onTrigger();
+        };
+        addAndMakeVisible(*triggerButton);
+    }
+
+    if (spec.hasSampleSelect)
+    {
+        sampleSelectCombo = std::make_unique<juce::ComboBox>();
+        sampleSelectCombo->addItem("Mecha Step 1", 1);
+        sampleSelectCombo->addItem("Mecha Step 2", 2);
+        sampleSelectCombo->addItem("Hydraulic Release", 3);
+        sampleSelectCombo->addItem("Metal Clank", 4);
+        sampleSelectCombo->addItem("Servo Motor", 5);
+        sampleSelectCombo->setSelectedId(1, juce::dontSendNotification);
+        sampleSelectCombo->onChange = [this]
+        {
+            if (onSampleSelected != nullptr)
+                onSampleSelected(sampleSelectCombo->getSelectedId() - 1);
+        };
+        addAndMakeVisible(*sampleSelectCombo);
+    }
+}
+
+ModulePanel::~ModulePanel()
+{
+    detach();
+}
+
+void ModulePanel::attach()
+{
+    if (attached)
+        return;
+
+    for (auto& widget : widgets)
+    {
+        if (widget->slider != nullptr)
+            sliderAttachments.emplace_back(std::make_unique<juce::AudioProcessorValueTreeState::SliderAttachment>(
+                valueTreeState, widget->parameterId, *widget->slider));
+        else if (widget->toggle != nullptr)
+            buttonAttachments.emplace_back(std::make_unique<juce::AudioProcessorValueTreeState::ButtonAttachment>(
+                valueTreeState, widget->parameterId, *widget->toggle));
+        else if (widget->combo != nullptr)
+            comboAttachments.emplace_back(std::make_unique<juce::AudioProcessorValueTreeState::ComboBoxAttachment>(
+                valueTreeState, widget->parameterId, *widget->combo));
+    }
+
+    attached = true;
+}
+
+void ModulePanel::detach()
+{
+    sliderAttachments.clear();
+    buttonAttachments.clear();
+    comboAttachments.clear();
+    attached = false;
+}
+
+void ModulePanel::setSelectedSample(int index)
+{
+    if (sampleSelectCombo != nullptr)
+        sampleSelectCombo->setSelectedId(index + 1, juce::dontSendNotification);
+}
+
+void ModulePanel::paint(juce::Graphics& g)
+{
+    g.fillAll(juce::Colour(0xff2a2a2a));
+
+    g.setColour(colour.withAlpha(0.6f));
+    g.drawRect(getLocalBounds(), 1);
+}
+
+void ModulePanel::resized()
+{
+    auto area = getLocalBounds().reduced(MARGIN);
+
+    // Switches and actions share the top row
+    auto headerRow = area.removeFromTop(BUTTON_HEIGHT);
+
+    for (auto& widget : widgets)
+        if (widget->toggle != nullptr)
+            widget->toggle->setBounds(headerRow.removeFromLeft(120));
+
+    if (triggerButton != nullptr)
+        triggerButton->setBounds(headerRow.removeFromLeft(80));
+
+    if (sampleSelectCombo != nullptr)
+    {
+        headerRow.removeFromLeft(MARGIN);
+        sampleSelectCombo->setBounds(headerRow.removeFromLeft(180));
+    }
+
+    area.removeFromTop(MARGIN);
+
+    // Sliders and choices in a grid, label above each
+    auto columnWidth = area.getWidth() / COLUMNS;
+    int column = 0;
+    juce::Rectangle<int> row;
+
+    for (auto& widget : widgets)
+    {
+        juce::Component* control = widget->slider != nullptr ? static_cast<juce::Component*>(widget->slider.get())
+                                                              : widget->combo.get();
+        if (control == nullptr)
+            continue;
+
+        if (column == 0)
+            row = area.removeFromTop(LABEL_HEIGHT + CONTROL_HEIGHT + 5);
+
+        auto cell = row.removeFromLeft(columnWidth).reduced(5, 0);
+        cell.removeFromTop(LABEL_HEIGHT);
+        control->setBounds(cell.removeFromTop(CONTROL_HEIGHT));
+
+        column = (column + 1) % COLUMNS;
+    }
+}
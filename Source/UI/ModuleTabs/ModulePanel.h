@@ -0,0 +1,75 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Controls for one sound generator, built from a list of parameter IDs.
+//
+// Each parameter gets the widget its type calls for: a toggle for switches, a
+// combo box for choices and a slider otherwise. Widgets are created once, but
+// their parameter attachments only exist between attach() and detach(), so a
+// panel sitting in a hidden tab costs nothing on parameter changes.
+class ModulePanel : public juce::Component
+{
+public:
+    struct Control
+    {
+        const char* parameterId;
+        const char* label;
+    };
+
+    struct Spec
+    {
+        const char* name;
+        juce::Colour colour;
+        std::vector<Control> controls;
+        bool hasTrigger = false;
+        bool hasSampleSelect = false;
+    };
+
+    ModulePanel(const Spec& spec, juce::AudioProcessorValueTreeState& vts);
+    ~ModulePanel() override;
+
+    void attach();
+    void detach();
+    bool isAttached() const { return attached; }
+
+    void setSelectedSample(int index);
+
+    std::function<void()> onTrigger;
+    std::function<void(int)> onSampleSelected;
+
+    void paint(juce::Graphics& g) override;
+    void resized() override;
+
+private:
+    struct Widget
+    {
+        juce::String parameterId;
+        juce::Label label;
+        std::unique_ptr<juce::Slider> slider;
+        std::unique_ptr<juce::ToggleButton> toggle;
+        std::unique_ptr<juce::ComboBox> combo;
+    };
+
+    juce::AudioProcessorValueTreeState& valueTreeState;
+    juce::Colour colour;
+
+    std::vector<std::unique_ptr<Widget>> widgets;
+    std::unique_ptr<juce::TextButton> triggerButton;
+    std::unique_ptr<juce::ComboBox> sampleSelectCombo;
+
+    // Parameter attachments, only while shown
+    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::SliderAttachment>> sliderAttachments;
+    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::ButtonAttachment>> buttonAttachments;
+    std::vector<std::unique_ptr<juce::AudioProcessorValueTreeState::ComboBoxAttachment>> comboAttachments;
+    bool attached = false;
+
+    // Layout constants
+    static constexpr int MARGIN = 10;
+    static constexpr int COLUMNS = 3;
+    static constexpr int LABEL_HEIGHT = 15;
+    static constexpr int CONTROL_HEIGHT = 25;
+    static constexpr int BUTTON_HEIGHT = 25;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModulePanel)
+};
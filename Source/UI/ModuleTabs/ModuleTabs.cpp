@@ -1,17 +1,141 @@
 #include "ModuleTabs.h"
 
-ModuleTabs::ModuleTabs()
+ModuleTabs::ModuleTabs(juce::AudioProcessorValueTreeState& vts, Actions actionsToUse)
+    : valueTreeState(vts), actions(std::move(actionsToUse))
 {
-    tabs.addTab("Servo", juce::Colours::lightblue, &servoPanel, false);
-    tabs.addTab("Hiss", juce::Colours::lightgreen, &hissPanel, false);
-    tabs.addTab("Impact", juce::Colours::lightcoral, &impactPanel, false);
-    tabs.addTab("Grind", juce::Colours::lightyellow, &grindPanel, false);
-    tabs.addTab("Sample", juce::Colours::lightgrey, &samplePanel, false);
+    for (const auto& spec : getSpecs())
+        tabBar.addTab(spec.name, spec.colour, -1);
 
-    addAndMakeVisible(tabs);
+    tabBar.addChangeListener(this);
+    addAndMakeVisible(tabBar);
+
+    tabBar.setCurrentTabIndex(0, false);
+    showModule(0);
+}
+
+ModuleTabs::~ModuleTabs()
+{
+    tabBar.removeChangeListener(this);
 }
 
 void ModuleTabs::resized()
 {
-    tabs.setBounds(getLocalBounds());
+    auto area = getLocalBounds();
+    tabBar.setBounds(area.removeFromTop(TAB_BAR_HEIGHT));
+
+    for (auto& panel : panels)
+        if (panel != nullptr)
+            panel->setBounds(area);
+}
+
+void ModuleTabs::refresh()
+{
+    auto now = juce::Time::getMillisecondCounter();
+
+    for (int i = 0; i < numModules; ++i)
+    {
+        auto& panel = panels[static_cast<size_t>(i)];
+
+        if (panel != nullptr && i != currentModule && now - hiddenSinceMs[static_cast<size_t>(i)] > releaseAfterMs)
+            panel.reset();
+    }
+}
+
+void ModuleTabs::setSelectedSample(int index)
+{
+    selectedSample = index;
+
+    if (auto& panel = panels[static_cast<size_t>(sample)])
+        panel->setSelectedSample(index);
+}
+
+const std::array<ModulePanel::Spec, ModuleTabs::numModules>& ModuleTabs::getSpecs()
+{
+    static const std::array<ModulePanel::Spec, numModules> specs
+    {
+        ModulePanel::Spec{ "Servo", juce::Colours::lightblue,
+            { { "SERVO_ENABLE", "Enable" }, { "SERVO_GAIN", "Gain" }, { "SERVO_SPEED", "Speed" },
+              { "SERVO_WHINE", "Whine" } } },
+
+        ModulePanel::Spec{ "Hiss", juce::Colours::lightgreen,
+            { { "HYDRAULIC_ENABLE", "Enable" }, { "HYDRAULIC_GAIN", "Gain" }, { "HYDRAULIC_PRESSURE", "Pressure" },
+              { "HYDRAULIC_FLOW", "Flow Rate" } } },
+
+        ModulePanel::Spec{ "Impact", juce::Colours::lightcoral,
+            { { "METAL_ENABLE", "Enable" }, { "METAL_GAIN", "Gain" }, { "METAL_RESONANCE", "Resonance" },
+              { "METAL_DECAY", "Decay" } },
+            true },
+
+        ModulePanel::Spec{ "Grind", juce::Colours::lightyellow,
+            { { "GEAR_ENABLE", "Enable" }, { "GEAR_GAIN", "Gain" }, { "GEAR_ROUGHNESS", "Roughness" },
+              { "GEAR_SPEED", "Speed" } } },
+
+        ModulePanel::Spec{ "Sample", juce::Colours::lightgrey,
+            { { "SAMPLE_ENABLE", "Enable" }, { "SAMPLE_GAIN", "Gain" }, { "SAMPLE_PITCH", "Pitch" },
+              { "SAMPLE_MODE", "Mode" }, { "SAMPLE_GRAIN_DENSITY", "Grain Density" },
+              { "SAMPLE_GRAIN_SIZE", "Grain Size" }, { "SAMPLE_GRAIN_POSITION", "Grain Position" },
+              { "SAMPLE_GRAIN_JITTER", "Position Jitter" }, { "SAMPLE_GRAIN_SPRAY", "Pitch Spray" } },
+            true, true }
+    };
+
+    return specs;
+}
+
+void ModuleTabs::changeListenerCallback(juce::ChangeBroadcaster*)
+{
+    showModule(tabBar.getCurrentTabIndex());
+}
+
+void ModuleTabs::showModule(int index)
+{
+    if (index == currentModule || !juce::isPositiveAndBelow(index, static_cast<int>(numModules)))
+        return;
+
+    if (juce::isPositiveAndBelow(currentModule, static_cast<int>(numModules)))
+    {
+        if (auto& previous = panels[static_cast<size_t>(currentModule)])
+        {
+            previous->detach();
+            previous->setVisible(false);
+        }
+
+        hiddenSinceMs[static_cast<size_t>(currentModule)] = juce::Time::getMillisecondCounter();
+    }
+
+    currentModule = index;
+
+    auto& panel = getOrCreatePanel(index);
+    panel.attach();
+    panel.setVisible(true);
+}
+
+ModulePanel& ModuleTabs::getOrCreatePanel(int index)
+{
+    auto& panel = panels[static_cast<size_t>(index)];
+
+    if (panel == nullptr)
+    {
+        panel = std::make_unique<ModulePanel>(getSpecs()[static_cast<size_t>(index)], valueTreeState);
+
+        if (index == impact)
+            panel->onTrigger = actions.triggerImpact;
+
+        if (index == sample)
+        {
+            panel->onTrigger = actions.triggerSample;
+            panel->setSelectedSample(selectedSample);
+            panel->onSampleSelected = [this](int sampleIndex)
+            {
+                selectedSample = sampleIndex;
+
+                if (actions.selectSample != nullptr)
+                    actions.selectSample(sampleIndex);
+            };
+        }
+
+        addChildComponent(*panel);
+        panel->setBounds(getLocalBounds().withTrimmedTop(TAB_BAR_HEIGHT));
+    }
+
+    return *panel;
 }
@@ -1,22 +1,62 @@
 #pragma once
 
 #include <JuceHeader.h>
+#include "ModulePanel.h"
 
-class ModuleTabs : public juce::Component
+// One tab per sound generator. A tab's panel is only built the first time the
+// tab is shown, and only the visible panel is attached to its parameters. Panels
+// left hidden for a while are released again; refresh() checks for that and is
+// meant to be called from the editor's timer.
+class ModuleTabs : public juce::Component,
+    private juce::ChangeListener
 {
 public:
-    ModuleTabs();
-    ~ModuleTabs() override = default;
+    // Actions the panels forward to the processor
+    struct Actions
+    {
+        std::function<void()> triggerImpact;
+        std::function<void()> triggerSample;
+        std::function<void(int)> selectSample;
+    };
+
+    ModuleTabs(juce::AudioProcessorValueTreeState& vts, Actions actionsToUse);
+    ~ModuleTabs() override;
 
     void resized() override;
+    void refresh();
+
+    // Shows the sample the processor has loaded without selecting it again
+    void setSelectedSample(int index);
 
 private:
-    juce::TabbedComponent tabs{ juce::TabbedButtonBar::TabsAtTop };
-
-    // Temporary placeholders (can be replaced with real panels later)
-    juce::Component servoPanel;
-    juce::Component hissPanel;
-    juce::Component impactPanel;
-    juce::Component grindPanel;
-    juce::Component samplePanel;
+    enum Module
+    {
+        servo,
+        hiss,
+        impact,
+        grind,
+        sample,
+        numModules
+    };
+
+    static const std::array<ModulePanel::Spec, numModules>& getSpecs();
+
+    void changeListenerCallback(juce::ChangeBroadcaster* source) override;
+    void showModule(int index);
+    ModulePanel& getOrCreatePanel(int index);
+
+    juce::AudioProcessorValueTreeState& valueTreeState;
+    Actions actions;
+
+    juce::TabbedButtonBar tabBar{ juce::TabbedButtonBar::TabsAtTop };
+
+    std::array<std::unique_ptr<ModulePanel>, numModules> panels;
+    std::array<juce::uint32, numModules> hiddenSinceMs{};
+    int currentModule = -1;
+    int selectedSample = -1; // none
+
+    static constexpr juce::uint32 releaseAfterMs = 30000;
+    static constexpr int TAB_BAR_HEIGHT = 30;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ModuleTabs)
 };
@@ -0,0 +1,200 @@
+#include "PaintProfiler.h"
+
+class PaintProfiler::TimingImage : public juce::CachedComponentImage
+{
+public:
+    TimingImage(PaintProfiler& profilerToUse, juce::Component& componentToTime, bool buffered)
+        : profiler(profilerToUse), owner(componentToTime), name(profilerToUse.describe(componentToTime))
+    {
+        if (buffered)
+            inner = std::make_unique<juce::StandardCachedComponentImage>(owner);
+    }
+
+    void paint(juce::Graphics& g) override
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+
+        if (inner != nullptr)
+            inner->paint(g);
+        else
+            owner.paintEntireComponent(g, false);
+
+        profiler.addSample(name, juce::Time::getHighResolutionTicks() - start);
+    }
+
+    bool invalidateAll() override { return inner == nullptr || inner->invalidateAll(); }
+    bool invalidate(const juce::Rectangle<int>& area) override { return inner == nullptr || inner->invalidate(area); }
+
+    void releaseResources() override
+    {
+        if (inner != nullptr)
+            inner->releaseResources();
+    }
+
+private:
+    PaintProfiler& profiler;
+    juce::Component& owner;
+    juce::String name;
+    std::unique_ptr<juce::StandardCachedComponentImage> inner;
+};
+
+PaintProfiler::PaintProfiler(juce::Component& componentToProfile)
+    : target(componentToProfile)
+{
+    setInterceptsMouseClicks(false, false);
+    current.reserve(64);
+}
+
+PaintProfiler::~PaintProfiler()
+{
+    detach();
+}
+
+void PaintProfiler::setProfiling(bool shouldProfile)
+{
+    if (shouldProfile == profiling)
+        return;
+
+    profiling = shouldProfile;
+    current.clear();
+    shown.clear();
+    windowStartMs = juce::Time::getMillisecondCounter();
+
+    if (profiling)
+        attach();
+    else
+        detach();
+
+    setVisible(profiling);
+    if (profiling)
+        toFront(false);
+}
+
+void PaintProfiler::addSample(const juce::String& name, juce::int64 ticks)
+{
+    if (!profiling)
+        return;
+
+    auto& stats = statsFor(name);
+    ++stats.paints;
+    stats.totalTicks += ticks;
+    stats.maxTicks = juce::jmax(stats.maxTicks, ticks);
+}
+
+void PaintProfiler::refresh()
+{
+    if (!profiling)
+        return;
+
+    auto now = juce::Time::getMillisecondCounter();
+    if (now - windowStartMs < 1000)
+        return;
+
+    windowStartMs = now;
+
+    shown = current;
+    std::sort(shown.begin(), shown.end(), [](const Stats& a, const Stats& b) { return a.totalTicks > b.totalTicks; });
+
+    for (auto& stats : current)
+        stats = { stats.name };
+
+    repaint(getLocalBounds().removeFromTop(rowHeight * (maxRows + 2)).removeFromRight(tableWidth));
+}
+
+void PaintProfiler::paint(juce::Graphics& g)
+{
+    auto table = getLocalBounds().removeFromTop(rowHeight * (maxRows + 2)).removeFromRight(tableWidth);
+
+    g.setColour(juce::Colours::black.withAlpha(0.8f));
+    g.fillRect(table);
+
+    g.setFont(juce::Font(juce::Font::getDefaultMonospacedFontName(), 11.0f, juce::Font::plain));
+    g.setColour(juce::Colours::white);
+
+    auto row = table.removeFromTop(rowHeight).reduced(4, 0);
+    g.drawText("component                  paints/s    avg us    max us", row, juce::Justification::left);
+
+    auto toMicroseconds = [](juce::int64 ticks)
+    {
+        return juce::Time::highResolutionTicksToSeconds(ticks) * 1.0e6;
+    };
+
+    for (int i = 0; i < juce::jmin(maxRows, static_cast<int>(shown.size())); ++i)
+    {
+        const auto& stats = shown[static_cast<size_t>(i)];
+        if (stats.paints == 0)
+            break;
+
+        row = table.removeFromTop(rowHeight).reduced(4, 0);
+
+        auto text = stats.name.substring(0, 24).paddedRight(' ', 24)
+            + juce::String(stats.paints).paddedLeft(' ', 11)
+            + juce::String(toMicroseconds(stats.totalTicks) / stats.paints, 1).paddedLeft(' ', 10)
+            + juce::String(toMicroseconds(stats.maxTicks), 1).paddedLeft(' ', 10);
+
+        g.drawText(text, row, juce::Justification::left);
+    }
+}
+
+PaintProfiler::Stats& PaintProfiler::statsFor(const juce::String& name)
+{
+    for (auto& stats : current)
+        if (stats.name == name)
+            return stats;
+
+    current.push_back({ name });
+    return current.back();
+}
+
+juce::String PaintProfiler::describe(juce::Component& child) const
+{
+    if (child.getName().isNotEmpty())
+        return child.getName();
+
+    if (auto* group = dynamic_cast<juce::GroupComponent*>(&child))
+        return "Group " + group->getText();
+
+    if (auto* button = dynamic_cast<juce::Button*>(&child))
+        return "Button " + button->getButtonText();
+
+    // Sliders and combo boxes are named after the label attached to them
+    for (auto* sibling : target.getChildren())
+        if (auto* label = dynamic_cast<juce::Label*>(sibling))
+            if (label->getAttachedComponent() == &child)
+                return (dynamic_cast<juce::Slider*>(&child) != nullptr ? "Slider " : "Control ") + label->getText();
+
+    if (auto* label = dynamic_cast<juce::Label*>(&child))
+        return "Label " + label->getText();
+
+    return "Component " + juce::String(target.getIndexOfChildComponent(&child));
+}
+
+void PaintProfiler::attach()
+{
+    for (auto* child : target.getChildren())
+    {
+        if (child == this)
+            continue;
+
+        auto buffered = dynamic_cast<juce::StandardCachedComponentImage*>(child->getCachedComponentImage()) != nullptr;
+        if (buffered)
+            wasBuffered.add(child);
+
+        child->setCachedComponentImage(new TimingImage(*this, *child, buffered));
+        wrapped.add(child);
+    }
+}
+
+void PaintProfiler::detach()
+{
+    for (auto& child : wrapped)
+        if (child != nullptr)
+            child->setCachedComponentImage(nullptr);
+
+    for (auto& child : wasBuffered)
+        if (child != nullptr)
+            child->setBufferedToImage(true);
+
+    wrapped.clear();
+    wasBuffered.clear();
+}
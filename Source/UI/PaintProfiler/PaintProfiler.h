@@ -0,0 +1,65 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Debug overlay showing how often, and how expensively, each part of an editor
+// repaints.
+//
+// While profiling, every direct child of the target gets a cached-image wrapper
+// that times its paintEntireComponent() (children of children are included in
+// their parent's time). Children that were buffered to an image keep their
+// buffering inside the wrapper, so cache hits show up as cheap paints. The
+// target's own paint() has no wrapper and reports itself through addSample().
+//
+// The table is refreshed once a second from refresh(). When hidden nothing is
+// wrapped or measured.
+class PaintProfiler : public juce::Component
+{
+public:
+    explicit PaintProfiler(juce::Component& componentToProfile);
+    ~PaintProfiler() override;
+
+    void setProfiling(bool shouldProfile);
+    bool isProfiling() const { return profiling; }
+
+    // For the target's own paint(); ticks from Time::getHighResolutionTicks()
+    void addSample(const juce::String& name, juce::int64 ticks);
+
+    // Call regularly from a timer
+    void refresh();
+
+    void paint(juce::Graphics& g) override;
+
+private:
+    class TimingImage;
+
+    struct Stats
+    {
+        juce::String name;
+        int paints = 0;
+        juce::int64 totalTicks = 0;
+        juce::int64 maxTicks = 0;
+    };
+
+    Stats& statsFor(const juce::String& name);
+    juce::String describe(juce::Component& child) const;
+    void attach();
+    void detach();
+
+    juce::Component& target;
+    bool profiling = false;
+
+    std::vector<Stats> current;
+    std::vector<Stats> shown;
+    juce::uint32 windowStartMs = 0;
+
+    // Children that were buffered before profiling, to restore afterwards
+    juce::Array<juce::Component::SafePointer<juce::Component>> wrapped;
+    juce::Array<juce::Component::SafePointer<juce::Component>> wasBuffered;
+
+    static constexpr int maxRows = 16;
+    static constexpr int rowHeight = 14;
+    static constexpr int tableWidth = 340;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(PaintProfiler)
+};
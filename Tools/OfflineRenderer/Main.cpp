@@ -0,0 +1,233 @@
+// Headless batch renderer for the asset pipeline.
+//
+//   OfflineRenderer --midi <file.mid> --preset <name|file> --out <file.wav|.flac>
+//                   [--rate 48000] [--block 512] [--tail 2] [--bits 24] [--seed 1] [--jobs N]
+//                   [--golden <file.wav>] [--tolerance -96] [--update-golden]
+//   OfflineRenderer --batch <jobs.txt> [--rate ...] [--jobs N]
+//
+// A batch file has one job per line: midi, preset, output and optionally a
+// golden file, separated by tabs, with paths relative to the batch file; blank
+// lines and lines starting with # are skipped. Jobs are spread over --jobs worker threads (all cores by default),
+// each with its own processor instance. Prints one line per file with its render
+// speed, then a summary. Exits non-zero if any job failed.
+//
+// Renders are deterministic for a given seed, so a batch with golden files is a
+// regression suite: each output is null-tested against its golden file and fails
+// if the peak difference is above --tolerance dBFS. --update-golden rewrites the
+// golden files (32-bit float) from the current build instead of comparing.
+// The scenarios in Regression/Scenarios.txt are the suite run before a release.
+
+#include <JuceHeader.h>
+#include "OfflineRenderer.h"
+
+namespace
+{
+    // Accepts both "--name value" and "--name=value"
+    juce::String optionValue(const juce::ArgumentList& args, const juce::String& name)
+    {
+        auto index = args.indexOfOption(name);
+        if (index < 0)
+            return {};
+
+        auto value = args.getValueForOption(name);
+        if (value.isEmpty() && index + 1 < args.size())
+            value = args[index + 1].text;
+
+        return value;
+    }
+
+    juce::Array<OfflineRenderer::Job> parseJobs(const juce::ArgumentList& args, juce::String& error)
+    {
+        OfflineRenderer::Job defaults;
+        auto cwd = juce::File::getCurrentWorkingDirectory();
+
+        if (args.containsOption("--rate"))
+            defaults.sampleRate = optionValue(args, "--rate").getDoubleValue();
+        if (args.containsOption("--block"))
+            defaults.blockSize = optionValue(args, "--block").getIntValue();
+        if (args.containsOption("--tail"))
+            defaults.tailSeconds = optionValue(args, "--tail").getDoubleValue();
+        if (args.containsOption("--bits"))
+            defaults.bitDepth = optionValue(args, "--bits").getIntValue();
+        if (args.containsOption("--seed"))
+            defaults.seed = optionValue(args, "--seed").getLargeIntValue();
+        if (args.containsOption("--tolerance"))
+            defaults.toleranceDb = optionValue(args, "--tolerance").getDoubleValue();
+
+        if (defaults.sampleRate <= 0.0 || defaults.blockSize <= 0 || defaults.tailSeconds < 0.0)
+        {
+            error = "Invalid --rate, --block or --tail";
+            return {};
+        }
+
+        juce::Array<OfflineRenderer::Job> jobs;
+
+        if (args.containsOption("--batch"))
+        {
+            auto batchFile = cwd.getChildFile(optionValue(args, "--batch"));
+            juce::StringArray lines;
+            batchFile.readLines(lines);
+
+            for (int i = 0; i < lines.size(); ++i)
+            {
+                auto line = lines[i].trim();
+                if (line.isEmpty() || line.startsWithChar('#'))
+                    continue;
+
+                auto fields = juce::StringArray::fromTokens(line, "\t", "\"");
+                if (fields.size() != 3 && fields.size() != 4)
+                {
+                    error = batchFile.getFileName() + " line " + juce::String(i + 1) + ": expected midi, preset, output and optional golden";
+                    return {};
+                }
+
+                // Relative to the batch file, so a suite can be run from anywhere
+                auto batchDirectory = batchFile.getParentDirectory();
+
+                auto job = defaults;
+                job.midiFile = batchDirectory.getChildFile(fields[0].trim());
+                job.preset = fields[1].trim();
+                job.outputFile = batchDirectory.getChildFile(fields[2].trim());
+
+                if (fields.size() == 4)
+                    job.goldenFile = batchDirectory.getChildFile(fields[3].trim());
+
+                jobs.add(job);
+            }
+        }
+        else if (args.containsOption("--midi") && args.containsOption("--preset") && args.containsOption("--out"))
+        {
+            auto job = defaults;
+            job.midiFile = cwd.getChildFile(optionValue(args, "--midi"));
+            job.preset = optionValue(args, "--preset");
+            job.outputFile = cwd.getChildFile(optionValue(args, "--out"));
+
+            if (args.containsOption("--golden"))
+                job.goldenFile = cwd.getChildFile(optionValue(args, "--golden"));
+
+            jobs.add(job);
+        }
+        else
+        {
+            error = "Need --midi, --preset and --out, or --batch";
+        }
+
+        return jobs;
+    }
+
+    // Pulls jobs off a shared counter until none are left
+    class RenderWorker : public juce::ThreadPoolJob
+    {
+    public:
+        RenderWorker(const juce::Array<OfflineRenderer::Job>& jobsToRun, std::vector<OfflineRenderer::Result>& resultsOut,
+            std::atomic<int>& nextJobIndex, juce::CriticalSection& outputLock, bool shouldUpdateGolden)
+            : juce::ThreadPoolJob("Render worker"), jobs(jobsToRun), results(resultsOut),
+              nextJob(nextJobIndex), printLock(outputLock), updateGolden(shouldUpdateGolden) {}
+
+        JobStatus runJob() override
+        {
+            OfflineRenderer renderer;
+
+            for (int index = nextJob++; index < jobs.size() && !shouldExit(); index = nextJob++)
+            {
+                const auto& job = jobs.getReference(index);
+                auto result = updateGolden ? renderAndUpdateGolden(renderer, job) : renderer.render(job);
+                results[static_cast<size_t>(index)] = result;
+
+                const juce::ScopedLock sl(printLock);
+
+                if (result.ok)
+                    std::cout << job.outputFile.getFileName() << ": " << juce::String(result.audioSeconds, 2) << " s audio in "
+                              << juce::String(result.renderSeconds, 3) << " s (" << juce::String(result.getRealtimeFactor(), 1)
+                              << "x real time)"
+                              << (result.compared ? ", residual " + juce::String(result.residualDb, 1) + " dB" : juce::String())
+                              << std::endl;
+                else
+                    std::cerr << job.outputFile.getFileName() << ": FAILED - " << result.error << std::endl;
+            }
+
+            return jobHasFinished;
+        }
+
+    private:
+        const juce::Array<OfflineRenderer::Job>& jobs;
+        std::vector<OfflineRenderer::Result>& results;
+        std::atomic<int>& nextJob;
+        juce::CriticalSection& printLock;
+        bool updateGolden;
+
+        static OfflineRenderer::Result renderAndUpdateGolden(OfflineRenderer& renderer, const OfflineRenderer::Job& job)
+        {
+            juce::AudioBuffer<float> output;
+            auto result = renderer.renderToBuffer(job, output);
+
+            if (result.ok)
+                result.ok = OfflineRenderer::writeAudioFile(job.outputFile, output, job.sampleRate, job.bitDepth, result.error)
+                         && (job.goldenFile == juce::File()
+                             || OfflineRenderer::writeAudioFile(job.goldenFile, output, job.sampleRate, 32, result.error));
+
+            return result;
+        }
+    };
+}
+
+int main(int argc, char* argv[])
+{
+    // Processors are built headless, without the preset services or timers of
+    // their own, but JUCE's parameter state still expects a message manager to
+    // exist; the message loop itself is never run
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ArgumentList args(argc, argv);
+    juce::String error;
+    auto jobs = parseJobs(args, error);
+
+    if (jobs.isEmpty())
+    {
+        std::cerr << (error.isNotEmpty() ? error : juce::String("No jobs")) << std::endl;
+        return 1;
+    }
+
+    auto numWorkers = args.containsOption("--jobs") ? optionValue(args, "--jobs").getIntValue()
+                                                    : juce::SystemStats::getNumCpus();
+    numWorkers = juce::jlimit(1, jobs.size(), numWorkers);
+
+    std::vector<OfflineRenderer::Result> results(static_cast<size_t>(jobs.size()));
+    std::atomic<int> nextJob{ 0 };
+    juce::CriticalSection printLock;
+
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    {
+        juce::OwnedArray<RenderWorker> workers; // outlives the pool
+        juce::ThreadPool pool(numWorkers);
+
+        for (int i = 0; i < numWorkers; ++i)
+            pool.addJob(workers.add(new RenderWorker(jobs, results, nextJob, printLock, args.containsOption("--update-golden"))), false);
+
+        // Blocks the main thread, so no message-thread work (timers, async
+        // callbacks) runs while rendering; renders only go through the
+        // processor's synchronous paths and don't need it
+        for (auto* worker : workers)
+            pool.waitForJobToFinish(worker, -1);
+    }
+
+    auto wallSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+
+    int failures = 0;
+    double audioSeconds = 0.0;
+
+    for (const auto& result : results)
+    {
+        if (result.ok)
+            audioSeconds += result.audioSeconds;
+        else
+            ++failures;
+    }
+
+    std::cout << jobs.size() - failures << " of " << jobs.size() << " files rendered on " << numWorkers << " workers: "
+              << juce::String(audioSeconds, 1) << " s audio in " << juce::String(wallSeconds, 2) << " s ("
+              << juce::String(wallSeconds > 0.0 ? audioSeconds / wallSeconds : 0.0, 1) << "x real time)" << std::endl;
+
+    return failures == 0 ? 0 : 1;
+}
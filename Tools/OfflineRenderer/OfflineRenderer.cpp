@@ -0,0 +1,257 @@
+#include "OfflineRenderer.h"
+#include "../../Source/Preset/FactoryPresets.h"
+#include "../../Source/Preset/PresetSerialization.h"
+
+OfflineRenderer::OfflineRenderer()
+{
+}
+
+OfflineRenderer::Result OfflineRenderer::render(const Job& job)
+{
+    juce::AudioBuffer<float> output;
+    auto result = renderToBuffer(job, output);
+
+    if (result.ok && !writeAudioFile(job.outputFile, output, job.sampleRate, job.bitDepth, result.error))
+        result.ok = false;
+
+    if (result.ok && job.goldenFile != juce::File())
+        result.ok = compareWithGolden(job, output, result);
+
+    return result;
+}
+
+OfflineRenderer::Result OfflineRenderer::renderToBuffer(const Job& job, juce::AudioBuffer<float>& output)
+{
+    Result result;
+    auto startTicks = juce::Time::getHighResolutionTicks();
+
+    juce::MidiMessageSequence sequence;
+    if (!readMidi(job.midiFile, sequence, result.error))
+        return result;
+
+    // A fresh processor per job, so smoothers, envelopes and modulation sources
+    // start from the same rest state whatever this worker rendered before. The
+    // preset goes in first so the first block already reads it.
+    auto processor = std::make_unique<GUNDAM_PluginAudioProcessor>(GUNDAM_PluginAudioProcessor::Mode::headless);
+    processor->setNonRealtime(true);
+
+    if (!applyPreset(*processor, job.preset, result.error))
+        return result;
+
+    processor->setRandomSeed(job.seed);
+    processor->setRateAndBufferSizeDetails(job.sampleRate, job.blockSize);
+    processor->prepareToPlay(job.sampleRate, job.blockSize);
+
+    auto lastEventSeconds = sequence.getNumEvents() > 0 ? sequence.getEndTime() : 0.0;
+    auto totalSamples = static_cast<int>(std::ceil((lastEventSeconds + job.tailSeconds) * job.sampleRate));
+
+    auto numChannels = juce::jmax(processor->getTotalNumInputChannels(), processor->getTotalNumOutputChannels());
+    auto numOutputs = processor->getTotalNumOutputChannels();
+
+    output.setSize(numOutputs, totalSamples);
+    juce::AudioBuffer<float> block(numChannels, job.blockSize);
+    juce::MidiBuffer midi;
+
+    int nextEvent = 0;
+
+    for (int position = 0; position < totalSamples; position += job.blockSize)
+    {
+        auto numSamples = juce::jmin(job.blockSize, totalSamples - position);
+        auto blockEndSeconds = (position + numSamples) / job.sampleRate;
+
+        // Events are sample accurate within the block
+        midi.clear();
+        while (nextEvent < sequence.getNumEvents())
+        {
+            const auto& message = sequence.getEventPointer(nextEvent)->message;
+            if (message.getTimeStamp() >= blockEndSeconds)
+                break;
+
+            auto offset = juce::roundToInt(message.getTimeStamp() * job.sampleRate) - position;
+            midi.addEvent(message, juce::jlimit(0, numSamples - 1, offset));
+            ++nextEvent;
+        }
+
+        block.setSize(numChannels, numSamples, false, false, true);
+        block.clear();
+        processor->processBlock(block, midi);
+
+        for (int channel = 0; channel < numOutputs; ++channel)
+            output.copyFrom(channel, position, block, channel, 0, numSamples);
+    }
+
+    result.ok = true;
+    result.audioSeconds = totalSamples / job.sampleRate;
+    result.renderSeconds = juce::Time::highResolutionTicksToSeconds(juce::Time::getHighResolutionTicks() - startTicks);
+    return result;
+}
+
+bool OfflineRenderer::writeAudioFile(const juce::File& file, const juce::AudioBuffer<float>& audio,
+    double sampleRate, int bitDepth, juce::String& error)
+{
+    std::unique_ptr<juce::AudioFormat> format;
+
+    if (file.hasFileExtension("flac"))
+        format = std::make_unique<juce::FlacAudioFormat>();
+    else if (file.hasFileExtension("wav"))
+        format = std::make_unique<juce::WavAudioFormat>();
+
+    if (format == nullptr)
+    {
+        error = "Unsupported output format: " + file.getFileName();
+        return false;
+    }
+
+    file.getParentDirectory().createDirectory();
+    file.deleteFile();
+
+    auto stream = std::make_unique<juce::FileOutputStream>(file);
+    if (!stream->openedOk())
+    {
+        error = "Cannot write " + file.getFullPathName();
+        return false;
+    }
+
+    std::unique_ptr<juce::AudioFormatWriter> writer(format->createWriterFor(stream.get(), sampleRate,
+        static_cast<unsigned int>(audio.getNumChannels()), bitDepth, {}, 0));
+
+    if (writer == nullptr)
+    {
+        error = "Cannot encode " + file.getFileName() + " at " + juce::String(bitDepth) + " bits";
+        return false;
+    }
+
+    // The writer owns the stream from here
+    stream.release();
+
+    if (!writer->writeFromAudioSampleBuffer(audio, 0, audio.getNumSamples()))
+    {
+        error = "Write failed: " + file.getFullPathName();
+        return false;
+    }
+
+    return true;
+}
+
+bool OfflineRenderer::readAudioFile(const juce::File& file, juce::AudioBuffer<float>& audio,
+    double& sampleRate, juce::String& error)
+{
+    juce::AudioFormatManager formats;
+    formats.registerBasicFormats();
+
+    std::unique_ptr<juce::AudioFormatReader> reader(formats.createReaderFor(file));
+    if (reader == nullptr)
+    {
+        error = "Cannot read " + file.getFullPathName();
+        return false;
+    }
+
+    audio.setSize(static_cast<int>(reader->numChannels), static_cast<int>(reader->lengthInSamples));
+    reader->read(&audio, 0, audio.getNumSamples(), 0, true, true);
+    sampleRate = reader->sampleRate;
+    return true;
+}
+
+double OfflineRenderer::getResidualDb(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b)
+{
+    if (a.getNumChannels() != b.getNumChannels())
+        return 0.0;
+
+    auto length = juce::jmax(a.getNumSamples(), b.getNumSamples());
+    float peak = 0.0f;
+
+    for (int channel = 0; channel < a.getNumChannels(); ++channel)
+    {
+        auto* dataA = a.getReadPointer(channel);
+        auto* dataB = b.getReadPointer(channel);
+
+        // Past the end of the shorter buffer the other one is compared with silence
+        for (int i = 0; i < length; ++i)
+        {
+            auto sampleA = i < a.getNumSamples() ? dataA[i] : 0.0f;
+            auto sampleB = i < b.getNumSamples() ? dataB[i] : 0.0f;
+            peak = juce::jmax(peak, std::abs(sampleA - sampleB));
+        }
+    }
+
+    return juce::Decibels::gainToDecibels(peak, -200.0f);
+}
+
+bool OfflineRenderer::compareWithGolden(const Job& job, const juce::AudioBuffer<float>& output, Result& result)
+{
+    juce::AudioBuffer<float> golden;
+    double goldenRate = 0.0;
+
+    if (!job.goldenFile.existsAsFile())
+    {
+        result.error = "no golden render " + job.goldenFile.getFileName() + "; create it with --update-golden";
+        return false;
+    }
+
+    if (!readAudioFile(job.goldenFile, golden, goldenRate, result.error))
+        return false;
+
+    if (goldenRate != job.sampleRate)
+    {
+        result.error = job.goldenFile.getFileName() + " is at " + juce::String(goldenRate) + " Hz, render is at "
+                     + juce::String(job.sampleRate) + " Hz";
+        return false;
+    }
+
+    result.compared = true;
+    result.residualDb = getResidualDb(output, golden);
+
+    if (result.residualDb > job.toleranceDb)
+    {
+        result.error = "differs from " + job.goldenFile.getFileName() + " by " + juce::String(result.residualDb, 1)
+                     + " dB (tolerance " + juce::String(job.toleranceDb, 1) + " dB)";
+        return false;
+    }
+
+    return true;
+}
+
+bool OfflineRenderer::applyPreset(GUNDAM_PluginAudioProcessor& processor, const juce::String& preset, juce::String& error)
+{
+    juce::MemoryBlock chunk;
+
+    for (int i = 0; i < FactoryPresets::numPresets; ++i)
+        if (preset == FactoryPresets::presets[i].name)
+            chunk = PresetSerialization::toBinary(FactoryPresets::values[static_cast<size_t>(i)]);
+
+    if (chunk.isEmpty())
+    {
+        PresetSerialization::Preset loaded;
+        if (!PresetSerialization::readFile(juce::File::getCurrentWorkingDirectory().getChildFile(preset), loaded))
+        {
+            error = "Unknown preset: " + preset;
+            return false;
+        }
+
+        chunk = PresetSerialization::toBinary(loaded);
+    }
+
+    // The same path a host takes when restoring a session
+    processor.setStateInformation(chunk.getData(), static_cast<int>(chunk.getSize()));
+    return true;
+}
+
+bool OfflineRenderer::readMidi(const juce::File& file, juce::MidiMessageSequence& sequence, juce::String& error)
+{
+    juce::FileInputStream stream(file);
+    juce::MidiFile midiFile;
+
+    if (!stream.openedOk() || !midiFile.readFrom(stream))
+    {
+        error = "Cannot read MIDI file " + file.getFullPathName();
+        return false;
+    }
+
+    midiFile.convertTimestampTicksToSeconds();
+
+    for (int track = 0; track < midiFile.getNumTracks(); ++track)
+        sequence.addSequence(*midiFile.getTrack(track), 0.0);
+
+    sequence.updateMatchedPairs();
+    return true;
+}
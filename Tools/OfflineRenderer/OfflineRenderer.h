@@ -0,0 +1,71 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include "../../Source/PluginProcessor.h"
+
+// Renders a Standard MIDI File through the plugin processor, headless and as
+// fast as the CPU allows, and writes the result as WAV or FLAC. A preset is a
+// factory preset name or a file path; the user's preset folder is never read.
+//
+// A renderer can run any number of jobs in turn. Each job gets a processor of
+// its own, with the preset applied before it is prepared, so a job renders the
+// same samples whatever ran before it. Use one renderer per worker thread.
+//
+// A job with a golden file is null-tested against it after rendering: the peak
+// of the difference must stay below the job's tolerance. This is how changes to
+// the DSP are checked against a reference render.
+class OfflineRenderer
+{
+public:
+    struct Job
+    {
+        juce::File midiFile;
+        juce::String preset;        // factory preset name or a preset file path
+        juce::File outputFile;      // .wav or .flac
+        double sampleRate = 48000.0;
+        int blockSize = 512;
+        double tailSeconds = 2.0;   // rendered after the last MIDI event
+        int bitDepth = 24;
+        juce::int64 seed = 1;       // noise seed; fixed so repeated renders match
+
+        juce::File goldenFile;      // optional reference render
+        double toleranceDb = -96.0; // largest allowed peak difference, dBFS
+    };
+
+    struct Result
+    {
+        bool ok = false;
+        juce::String error;
+        double audioSeconds = 0.0;
+        double renderSeconds = 0.0;
+
+        bool compared = false;
+        double residualDb = 0.0;    // peak difference from the golden file, dBFS
+
+        double getRealtimeFactor() const { return renderSeconds > 0.0 ? audioSeconds / renderSeconds : 0.0; }
+    };
+
+    OfflineRenderer();
+
+    Result render(const Job& job);
+
+    // Renders into memory without writing a file; used for comparisons
+    Result renderToBuffer(const Job& job, juce::AudioBuffer<float>& output);
+
+    static bool writeAudioFile(const juce::File& file, const juce::AudioBuffer<float>& audio,
+        double sampleRate, int bitDepth, juce::String& error);
+
+    static bool readAudioFile(const juce::File& file, juce::AudioBuffer<float>& audio,
+        double& sampleRate, juce::String& error);
+
+    // Peak of a - b in dBFS, over the longer of the two and every channel of
+    // either; 0 dB if the channel counts differ
+    static double getResidualDb(const juce::AudioBuffer<float>& a, const juce::AudioBuffer<float>& b);
+
+private:
+    static bool applyPreset(GUNDAM_PluginAudioProcessor& processor, const juce::String& preset, juce::String& error);
+    static bool compareWithGolden(const Job& job, const juce::AudioBuffer<float>& output, Result& result);
+    static bool readMidi(const juce::File& file, juce::MidiMessageSequence& sequence, juce::String& error);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(OfflineRenderer)
+};